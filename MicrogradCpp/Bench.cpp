@@ -0,0 +1,277 @@
+#include "Bench.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <thread>
+
+namespace bench {
+
+    // ----------------------------------------------------------------------
+    // STATE
+    // ----------------------------------------------------------------------
+
+    State::State(int64_t max_iterations, std::vector<int64_t> args)
+        : _max_iterations(max_iterations), _args(std::move(args))
+    {
+    }
+
+    void State::start() {
+        _running = true;
+        _real_start = std::chrono::steady_clock::now();
+        _cpu_start = std::clock();
+    }
+
+    void State::stop() {
+        if (!_running) return;
+        _running = false;
+        _real_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _real_start).count();
+        _cpu_seconds += (double)(std::clock() - _cpu_start) / CLOCKS_PER_SEC;
+    }
+
+    void State::pause_timing() { stop(); }
+    void State::resume_timing() { start(); }
+
+    State::Iterator State::begin() {
+        start();
+        return Iterator{ this, _max_iterations };
+    }
+
+    bool State::Iterator::operator!=(const Iterator&) const {
+        if (left > 0) return true;
+        state->stop();
+        return false;
+    }
+
+    // ----------------------------------------------------------------------
+    // REGISTRY
+    // ----------------------------------------------------------------------
+
+    static std::vector<std::unique_ptr<Benchmark>>& registry() {
+        static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+        return benchmarks;
+    }
+
+    Benchmark* register_benchmark(const std::string& name, std::function<void(State&)> fn) {
+        registry().push_back(std::unique_ptr<Benchmark>(new Benchmark{ name, std::move(fn), {} }));
+        return registry().back().get();
+    }
+
+    // ----------------------------------------------------------------------
+    // RUNNER
+    // ----------------------------------------------------------------------
+
+    struct Result {
+        std::string name;
+        int64_t iterations;
+        double real_ns; // per iteration
+        double cpu_ns;  // per iteration
+        double items_per_second;
+        double bytes_per_second;
+        std::map<std::string, double> counters;
+        std::string error; // set by skip_with_error()
+    };
+
+    struct Runner {
+        double min_time = 0.5; // seconds per case
+
+        Result run(const Benchmark& b, const std::vector<int64_t>& args, const std::string& name) {
+            int64_t iters = 1;
+            for (;;) {
+                State state(iters, args);
+                b.fn(state);
+                state.stop();
+
+                if (!state._error.empty()) {
+                    Result r{};
+                    r.name = name;
+                    r.error = state._error;
+                    return r;
+                }
+
+                double t = state._real_seconds;
+                if (t >= min_time || iters >= 1000000000) {
+                    Result r;
+                    r.name = name;
+                    r.iterations = iters;
+                    r.real_ns = t * 1e9 / iters;
+                    r.cpu_ns = state._cpu_seconds * 1e9 / iters;
+                    r.items_per_second = (state._items && t > 0) ? state._items / t : 0.0;
+                    r.bytes_per_second = (state._bytes && t > 0) ? state._bytes / t : 0.0;
+                    r.counters = state.counters;
+                    return r;
+                }
+
+                // Aim 40% past min_time, growing by at most 10x per attempt
+                double mult = t > 0 ? min_time * 1.4 / t : 10.0;
+                mult = std::min(10.0, std::max(2.0, mult));
+                iters = std::min<int64_t>(1000000000, (int64_t)(iters * mult));
+            }
+        }
+    };
+
+    static std::string case_name(const Benchmark& b, const std::vector<int64_t>& args) {
+        std::string name = b.name;
+        for (int64_t a : args) {
+            name += "/" + std::to_string(a);
+        }
+        return name;
+    }
+
+    static std::string format_time(double ns) {
+        char buf[32];
+        if (ns < 1e4) std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+        else if (ns < 1e7) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+        return buf;
+    }
+
+    static std::string format_rate(double per_second) {
+        char buf[32];
+        if (per_second >= 1e9) std::snprintf(buf, sizeof(buf), "%.3gG/s", per_second / 1e9);
+        else if (per_second >= 1e6) std::snprintf(buf, sizeof(buf), "%.3gM/s", per_second / 1e6);
+        else if (per_second >= 1e3) std::snprintf(buf, sizeof(buf), "%.3gk/s", per_second / 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.3g/s", per_second);
+        return buf;
+    }
+
+    static void print_row(const Result& r) {
+        if (!r.error.empty()) {
+            std::cout << r.name << " ERROR: " << r.error << std::endl;
+            return;
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-40s %14s %14s %12lld", r.name.c_str(),
+                      format_time(r.real_ns).c_str(), format_time(r.cpu_ns).c_str(), (long long)r.iterations);
+        std::cout << line;
+        if (r.items_per_second > 0) std::cout << " items=" << format_rate(r.items_per_second);
+        if (r.bytes_per_second > 0) std::cout << " bytes=" << format_rate(r.bytes_per_second);
+        for (auto& c : r.counters) {
+            std::cout << " " << c.first << "=" << c.second;
+        }
+        std::cout << std::endl;
+    }
+
+    static std::string json_string(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    static void write_json(std::ostream& os, const std::vector<Result>& results) {
+        char date[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        os.precision(17);
+        os << "{\n  \"context\": {\n"
+           << "    \"date\": " << json_string(date) << ",\n"
+           << "    \"executable\": \"microgradcpp_bench\",\n"
+           << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+           << "    \"isa\": " << json_string(kernels::isa()) << ",\n"
+#ifdef NDEBUG
+           << "    \"library_build_type\": \"release\"\n"
+#else
+           << "    \"library_build_type\": \"debug\"\n"
+#endif
+           << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << (i ? ",\n" : "\n") << "    {\n"
+               << "      \"name\": " << json_string(r.name) << ",\n"
+               << "      \"run_name\": " << json_string(r.name) << ",\n"
+               << "      \"run_type\": \"iteration\",\n"
+               << "      \"repetitions\": 1,\n"
+               << "      \"repetition_index\": 0,\n"
+               << "      \"threads\": 1,\n";
+            if (!r.error.empty()) {
+                os << "      \"error_occurred\": true,\n"
+                   << "      \"error_message\": " << json_string(r.error) << "\n    }";
+                continue;
+            }
+            os
+               << "      \"iterations\": " << r.iterations << ",\n"
+               << "      \"real_time\": " << r.real_ns << ",\n"
+               << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+               << "      \"time_unit\": \"ns\"";
+            if (r.items_per_second > 0) os << ",\n      \"items_per_second\": " << r.items_per_second;
+            if (r.bytes_per_second > 0) os << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+            for (auto& c : r.counters) {
+                os << ",\n      " << json_string(c.first) << ": " << c.second;
+            }
+            os << "\n    }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    static bool flag(const char* arg, const char* name, std::string& value) {
+        size_t n = std::strlen(name);
+        if (std::strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+        value = arg + n + 1;
+        return true;
+    }
+
+    int run(int argc, char** argv) {
+        Runner runner;
+        std::string filter = ".", out_path, format = "console", value;
+        bool list_only = false;
+
+        for (int i = 1; i < argc; ++i) {
+            if (flag(argv[i], "--benchmark_filter", value)) filter = value;
+            else if (flag(argv[i], "--benchmark_min_time", value)) runner.min_time = std::stod(value); // "0.5" or "0.5s"
+            else if (flag(argv[i], "--benchmark_out", value)) out_path = value;
+            else if (flag(argv[i], "--benchmark_out_format", value) && value == "json") {}
+            else if (flag(argv[i], "--benchmark_format", value) && (value == "console" || value == "json")) format = value;
+            else if (std::strcmp(argv[i], "--benchmark_list_tests") == 0) list_only = true;
+            else {
+                std::cerr << "unknown argument: " << argv[i] << "\n"
+                          << "usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]\n"
+                          << "       [--benchmark_out=<file.json>] [--benchmark_format=console|json] [--benchmark_list_tests]\n";
+                return 1;
+            }
+        }
+
+        std::regex re(filter);
+        std::vector<Result> results;
+        bool console = format == "console";
+        if (console && !list_only) {
+            std::cout << "isa: " << kernels::isa() << "\n";
+            char header[160];
+            std::snprintf(header, sizeof(header), "%-40s %14s %14s %12s", "Benchmark", "Time", "CPU", "Iterations");
+            std::cout << header << "\n" << std::string(std::strlen(header), '-') << std::endl;
+        }
+
+        for (auto& b : registry()) {
+            std::vector<std::vector<int64_t>> cases = b->args;
+            if (cases.empty()) cases.push_back({});
+            for (auto& args : cases) {
+                std::string name = case_name(*b, args);
+                if (!std::regex_search(name, re)) continue;
+                if (list_only) {
+                    std::cout << name << "\n";
+                    continue;
+                }
+                results.push_back(runner.run(*b, args, name));
+                if (console) print_row(results.back());
+            }
+        }
+
+        if (!console) write_json(std::cout, results);
+        if (!out_path.empty()) {
+            std::ofstream f(out_path);
+            if (!f) {
+                std::cerr << "cannot open " << out_path << "\n";
+                return 1;
+            }
+            write_json(f, results);
+        }
+        return 0;
+    }
+}
\ No newline at end of file
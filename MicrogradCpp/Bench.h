@@ -0,0 +1,116 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------------------------
+// BENCHMARK HARNESS
+// --------------------------------------------------------------------------
+// A small self-contained subset of the Google Benchmark API, so the bench
+// target builds anywhere the library does:
+//
+//     static void BM_Add(bench::State& state) {
+//         auto a = ..., b = ...;              // setup, not timed
+//         for (auto _ : state) {
+//             bench::do_not_optimize(a + b);  // timed
+//         }
+//         state.set_items_processed(state.iterations());
+//     }
+//     BENCHMARK(BM_Add);
+//     BENCHMARK(BM_Backward)->Arg(1000)->Arg(1000000);
+//
+// Each case runs with a growing iteration count until it takes at least
+// --benchmark_min_time seconds. Results print as a table, and
+// --benchmark_out=<file> also writes them as JSON in Google Benchmark's
+// schema (so its compare.py tooling can diff two runs).
+
+namespace bench {
+
+    // Keeps the compiler from optimizing away a computed value
+    template <class T>
+    inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    class State {
+      public:
+        State(int64_t max_iterations, std::vector<int64_t> args);
+
+        // Arguments of this case, from Arg()/Args()
+        int64_t range(size_t i = 0) const { return _args[i]; }
+        int64_t iterations() const { return _max_iterations; }
+
+        // Exclude setup inside the loop from the measurement
+        void pause_timing();
+        void resume_timing();
+
+        // Reported as items_per_second / bytes_per_second
+        void set_items_processed(int64_t n) { _items = n; }
+        void set_bytes_processed(int64_t n) { _bytes = n; }
+
+        // Extra values reported next to the timings (e.g. "nodes")
+        std::map<std::string, double> counters;
+
+        // Marks the case failed (e.g. its fixture could not be written);
+        // call it before the timing loop and return
+        void skip_with_error(const std::string& message) { _error = message; }
+
+        // Range-for support: `for (auto _ : state)` runs iterations() times
+        struct [[maybe_unused]] Unused {};
+        struct Iterator {
+            State* state;
+            int64_t left;
+            bool operator!=(const Iterator&) const;
+            void operator++() { --left; }
+            Unused operator*() const { return Unused{}; }
+        };
+        Iterator begin();
+        Iterator end() { return Iterator{ this, 0 }; }
+
+      private:
+        friend struct Runner;
+        int64_t _max_iterations;
+        std::vector<int64_t> _args;
+        int64_t _items = 0;
+        int64_t _bytes = 0;
+        std::string _error;
+
+        bool _running = false;
+        std::chrono::steady_clock::time_point _real_start;
+        std::clock_t _cpu_start = 0;
+        double _real_seconds = 0.0;
+        double _cpu_seconds = 0.0;
+
+        void start();
+        void stop();
+    };
+
+    struct Benchmark {
+        std::string name;
+        std::function<void(State&)> fn;
+        std::vector<std::vector<int64_t>> args; // one entry per case
+
+        Benchmark* Arg(int64_t a) { args.push_back({ a }); return this; }
+        Benchmark* Args(std::vector<int64_t> a) { args.push_back(std::move(a)); return this; }
+        Benchmark* Apply(void (*f)(Benchmark*)) { f(this); return this; }
+    };
+
+    Benchmark* register_benchmark(const std::string& name, std::function<void(State&)> fn);
+
+    // Parses --benchmark_* flags, runs every registered case, returns an exit code
+    int run(int argc, char** argv);
+}
+
+#define BENCHMARK_CAT_(a, b) a##b
+#define BENCHMARK_CAT(a, b) BENCHMARK_CAT_(a, b)
+#define BENCHMARK(fn) \
+    static ::bench::Benchmark* BENCHMARK_CAT(_benchmark_, __LINE__) = ::bench::register_benchmark(#fn, fn)
@@ -0,0 +1,616 @@
+#include "Bench.h"
+#include "DataLoader.h"
+#include "Graph.h"
+#include "MLP.h"
+#include "Optimizer.h"
+#include "Quantize.h"
+#include "Server.h"
+#include "Sparse.h"
+#include "StaticMLP.h"
+#include "Tape.h"
+#include "Tensor.h"
+#include "ThreadPool.h"
+#include "Trainer.h"
+#include "Value.h"
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+// --------------------------------------------------------------------------
+// BENCHMARKS
+// --------------------------------------------------------------------------
+// Run everything:           microgradcpp_bench
+// Subset, JSON for diffing: microgradcpp_bench --benchmark_filter=MLP --benchmark_out=run.json
+//
+// items_per_second is ops/s for the per-op cases, nodes/s for backward,
+// samples/s for the MLP passes, steps/s for the training steps and
+// requests/s for the server.
+
+static std::mt19937 rng(1234);
+
+static std::shared_ptr<Tensor> random_tensor(int rows, int cols) {
+    std::uniform_real_distribution<> dis(-1.0, 1.0);
+    std::vector<Scalar> data((size_t)rows * cols);
+    for (Scalar& d : data) d = (Scalar)dis(rng);
+    return Tensor::from_data(rows, cols, std::move(data));
+}
+
+// ----------------------------------------------------------------------
+// 1. Per-op cost of the scalar engine (node allocation + closure)
+// ----------------------------------------------------------------------
+
+static void BM_ValueAdd(bench::State& state) {
+    auto a = std::make_shared<Value>(0.5);
+    auto b = std::make_shared<Value>(-1.5);
+    for (auto _ : state) {
+        bench::do_not_optimize(a + b);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_ValueAdd);
+
+static void BM_ValueMul(bench::State& state) {
+    auto a = std::make_shared<Value>(0.5);
+    auto b = std::make_shared<Value>(-1.5);
+    for (auto _ : state) {
+        bench::do_not_optimize(a * b);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_ValueMul);
+
+static void BM_ValueTanh(bench::State& state) {
+    auto a = std::make_shared<Value>(0.5);
+    for (auto _ : state) {
+        bench::do_not_optimize(a->tanh());
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_ValueTanh);
+
+static void BM_TapeOps(bench::State& state) {
+    // add + mul + tanh per iteration, on a tape that is reset every 4096 ops
+    Tape tape;
+    Var a = tape.leaf(0.5);
+    Var b = tape.leaf(-1.5);
+    int64_t n = 0;
+    for (auto _ : state) {
+        if (++n % 4096 == 0) {
+            tape.reset();
+            a = tape.leaf(0.5);
+            b = tape.leaf(-1.5);
+        }
+        bench::do_not_optimize(((a + b) * b).tanh().index);
+    }
+    state.set_items_processed(state.iterations() * 3);
+}
+BENCHMARK(BM_TapeOps);
+
+// ----------------------------------------------------------------------
+// 2. backward() on graphs of 1e3 .. 1e7 nodes
+// ----------------------------------------------------------------------
+// A chain of cur = tanh(cur * x[i] + x[i+1]) over 64 shared leaves: long
+// dependency chains plus high-fan-out leaves, 3 nodes per step.
+// (The 1e7 Value graph needs a few GB of memory.)
+
+static const int GRAPH_LEAVES = 64;
+
+static void graph_sizes(bench::Benchmark* b) {
+    for (int64_t n = 1000; n <= 10000000; n *= 10) {
+        b->Arg(n);
+    }
+}
+
+static void BM_ValueBackward(bench::State& state) {
+    std::vector<std::shared_ptr<Value>> x;
+    for (int i = 0; i < GRAPH_LEAVES; ++i) {
+        x.push_back(std::make_shared<Value>(0.01 * (i + 1)));
+    }
+    const int64_t steps = (state.range(0) - GRAPH_LEAVES) / 3;
+    std::shared_ptr<Value> cur = x[0];
+    for (int64_t i = 0; i < steps; ++i) {
+        cur = (cur * x[i % GRAPH_LEAVES] + x[(i + 1) % GRAPH_LEAVES])->tanh();
+    }
+
+    for (auto _ : state) {
+        cur->backward();
+    }
+    state.counters["nodes"] = (double)(GRAPH_LEAVES + 3 * steps);
+    state.set_items_processed(state.iterations() * (GRAPH_LEAVES + 3 * steps));
+}
+BENCHMARK(BM_ValueBackward)->Apply(graph_sizes);
+
+static void BM_TapeBackward(bench::State& state) {
+    Tape tape;
+    std::vector<Var> x;
+    for (int i = 0; i < GRAPH_LEAVES; ++i) {
+        x.push_back(tape.leaf(0.01 * (i + 1)));
+    }
+    const int64_t steps = (state.range(0) - GRAPH_LEAVES) / 3;
+    Var cur = x[0];
+    for (int64_t i = 0; i < steps; ++i) {
+        cur = (cur * x[i % GRAPH_LEAVES] + x[(i + 1) % GRAPH_LEAVES]).tanh();
+    }
+
+    for (auto _ : state) {
+        tape.propagate(cur);
+    }
+    state.counters["nodes"] = (double)tape.size();
+    state.set_items_processed(state.iterations() * tape.size());
+}
+BENCHMARK(BM_TapeBackward)->Apply(graph_sizes);
+
+// ----------------------------------------------------------------------
+// 3. MLP passes: MLP(width, {width, width, 1}) on a batch of rows
+// ----------------------------------------------------------------------
+
+static void widths_and_batches(bench::Benchmark* b) {
+    for (int64_t width : { 16, 64, 256 }) {
+        for (int64_t batch : { 1, 32, 256 }) {
+            b->Args({ width, batch });
+        }
+    }
+}
+
+static void BM_MLPForward(bench::State& state) {
+    const int width = (int)state.range(0), batch = (int)state.range(1);
+    MLP model(width, { width, width, 1 });
+    auto X = random_tensor(batch, width);
+
+    for (auto _ : state) {
+        bench::do_not_optimize(model(X)->data[0]);
+    }
+    state.set_items_processed(state.iterations() * batch);
+}
+BENCHMARK(BM_MLPForward)->Apply(widths_and_batches);
+
+static void BM_MLPForwardBackward(bench::State& state) {
+    const int width = (int)state.range(0), batch = (int)state.range(1);
+    MLP model(width, { width, width, 1 });
+    auto X = random_tensor(batch, width);
+    auto Y = random_tensor(batch, 1);
+
+    for (auto _ : state) {
+        auto loss = model(X)->sub(Y)->pow(2)->sum();
+        model.zero_grad();
+        loss->backward();
+    }
+    state.set_items_processed(state.iterations() * batch);
+}
+BENCHMARK(BM_MLPForwardBackward)->Apply(widths_and_batches);
+
+static void BM_MLPValueForwardBackward(bench::State& state) {
+    // The scalar Value graph, one sample at a time
+    const int width = (int)state.range(0);
+    MLP model(width, { width, width, 1 });
+    std::vector<std::shared_ptr<Value>> x;
+    for (int i = 0; i < width; ++i) {
+        x.push_back(std::make_shared<Value>(0.01 * i));
+    }
+
+    for (auto _ : state) {
+        auto loss = model(x)[0]->pow(2);
+        model.zero_grad();
+        loss->backward();
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_MLPValueForwardBackward)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_MLPValueBackwardParallel(bench::State& state) {
+    // Backward over the Value graph of 8 samples, level-scheduled on a pool
+    const int width = (int)state.range(0), threads = (int)state.range(1), batch = 8;
+    MLP model(width, { width, width, 1 });
+    ThreadPool pool(threads);
+    std::shared_ptr<Value> loss = std::make_shared<Value>(0.0);
+    for (int b = 0; b < batch; ++b) {
+        std::vector<std::shared_ptr<Value>> x;
+        for (int i = 0; i < width; ++i) {
+            x.push_back(std::make_shared<Value>(0.01 * (i + b)));
+        }
+        loss = loss + model(x)[0]->pow(2);
+    }
+
+    for (auto _ : state) {
+        model.zero_grad();
+        loss->backward(pool, true);
+    }
+    state.set_items_processed(state.iterations() * batch);
+}
+BENCHMARK(BM_MLPValueBackwardParallel)->Args({ 256, 1 })->Args({ 256, 2 })->Args({ 256, 4 })->Args({ 256, 8 });
+
+static void BM_MLPPredict(bench::State& state) {
+    const int width = (int)state.range(0);
+    MLP model(width, { width, width, 1 });
+    std::vector<Scalar> x(width, 0.5);
+    Scalar out;
+
+    for (auto _ : state) {
+        model.predict(x.data(), &out);
+        bench::do_not_optimize(out);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_MLPPredict)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_QuantizedPredict(bench::State& state) {
+    // BM_MLPPredict on the int8 model; counters report its accuracy and size
+    const int width = (int)state.range(0);
+    MLP model(width, { width, width, 1 });
+    QuantizedMLP quantized(model);
+    std::vector<Scalar> x(width, 0.5);
+    Scalar out;
+
+    for (auto _ : state) {
+        quantized.predict(x.data(), &out);
+        bench::do_not_optimize(out);
+    }
+    QuantizationReport report = compare_quantized(model, quantized, random_tensor(256, width));
+    state.counters["rel_rmse"] = report.rmse / report.reference_rms;
+    state.counters["size_ratio"] = (double)report.model_bytes / report.quantized_bytes;
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_QuantizedPredict)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+// The Test.cpp model, MLP(3, {4, 4, 1}): dynamic vs compile-time architecture
+
+static const std::vector<std::vector<Scalar>> tiny_xs = { { 2.0, 3.0, -1.0 }, { 3.0, -1.0, 0.5 }, { 0.5, 1.0, 1.0 }, { 1.0, 1.0, -1.0 } };
+static const std::vector<std::vector<Scalar>> tiny_ys = { { 1.0 }, { -1.0 }, { -1.0 }, { 1.0 } };
+
+static void BM_TinyMLPPredict(bench::State& state) {
+    MLP model(3, { 4, 4, 1 });
+    Scalar out;
+    for (auto _ : state) {
+        model.predict(tiny_xs[0].data(), &out);
+        bench::do_not_optimize(out);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_TinyMLPPredict);
+
+static void BM_StaticMLPPredict(bench::State& state) {
+    StaticMLP<3, 4, 4, 1> model;
+    Scalar out;
+    for (auto _ : state) {
+        model.predict(tiny_xs[0].data(), &out);
+        bench::do_not_optimize(out);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_StaticMLPPredict);
+
+static void BM_TinyTrainStep(bench::State& state) {
+    // The Test.cpp loop: the 4 samples as one batch
+    MLP model(3, { 4, 4, 1 });
+    SGD optimizer(model, 0.01);
+    auto X = Tensor::from_rows(tiny_xs);
+    auto Y = Tensor::from_rows(tiny_ys);
+    for (auto _ : state) {
+        auto loss = model(X)->sub(Y)->pow(2)->sum();
+        optimizer.zero_grad();
+        loss->backward();
+        optimizer.step();
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_TinyTrainStep);
+
+static void BM_StaticTrainStep(bench::State& state) {
+    StaticMLP<3, 4, 4, 1> model;
+    for (auto _ : state) {
+        model.zero_grad();
+        Scalar loss = 0.0;
+        for (size_t i = 0; i < tiny_xs.size(); ++i) {
+            loss += model.train_sample(tiny_xs[i].data(), tiny_ys[i].data());
+        }
+        model.sgd_step(0.01);
+        bench::do_not_optimize(loss);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_StaticTrainStep);
+
+// ----------------------------------------------------------------------
+// 4. End-to-end training steps (forward, loss, backward, Adam update)
+// ----------------------------------------------------------------------
+
+static void BM_TrainStep(bench::State& state) {
+    const int width = (int)state.range(0), batch = (int)state.range(1);
+    MLP model(width, { width, width, 1 });
+    Adam optimizer(model, 1e-3);
+    auto X = random_tensor(batch, width);
+    auto Y = random_tensor(batch, 1);
+
+    for (auto _ : state) {
+        auto loss = model(X)->sub(Y)->pow(2)->sum();
+        optimizer.zero_grad();
+        loss->backward();
+        optimizer.step();
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_TrainStep)->Apply(widths_and_batches);
+
+static void BM_TrainStepCheckpointed(bench::State& state) {
+    // BM_TrainStep on a deeper MLP, keeping only per-layer outputs (arg 2 = k)
+    const int width = (int)state.range(0), batch = (int)state.range(1);
+    MLP model(width, { width, width, width, width, width, width, width, 1 });
+    model.checkpoint_every = (int)state.range(2);
+    Adam optimizer(model, 1e-3);
+    auto X = random_tensor(batch, width);
+    auto Y = random_tensor(batch, 1);
+
+    for (auto _ : state) {
+        auto loss = model(X)->sub(Y)->pow(2)->sum();
+        optimizer.zero_grad();
+        loss->backward();
+        optimizer.step();
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_TrainStepCheckpointed)->Args({ 256, 256, 0 })->Args({ 256, 256, 1 })->Args({ 256, 256, 2 });
+
+static void BM_TrainStepDataParallel(bench::State& state) {
+    const int width = (int)state.range(0), batch = (int)state.range(1);
+    MLP model(width, { width, width, 1 });
+    Adam optimizer(model, 1e-3);
+    DataParallelTrainer trainer(model);
+    auto X = random_tensor(batch, width);
+    auto Y = random_tensor(batch, 1);
+
+    for (auto _ : state) {
+        optimizer.zero_grad();
+        bench::do_not_optimize(trainer.backward(X, Y));
+        optimizer.step();
+    }
+    state.counters["threads"] = trainer.pool.size();
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_TrainStepDataParallel)->Args({ 64, 256 })->Args({ 256, 256 })->Args({ 256, 1024 });
+
+// Convergence against wall-clock: 4 epochs of batch-8 SGD over 8192 rows of
+// y = tanh(x . a), MLP(16, {32, 32, 1}), from the same initial weights every
+// iteration. loss is the mean per-row loss of the last epoch.
+
+static const int CONVERGENCE_ROWS = 8192, CONVERGENCE_EPOCHS = 4, CONVERGENCE_BATCH = 8;
+static const double CONVERGENCE_LR = 0.002;
+
+static void teacher_data(std::shared_ptr<Tensor>& X, std::shared_ptr<Tensor>& Y) {
+    X = random_tensor(CONVERGENCE_ROWS, 16);
+    auto a = random_tensor(16, 1);
+    Y = Tensor::zeros(CONVERGENCE_ROWS, 1);
+    for (int r = 0; r < CONVERGENCE_ROWS; ++r) {
+        Scalar dot = 0.0;
+        for (int c = 0; c < 16; ++c) dot += X->at(r, c) * a->data[c];
+        Y->data[r] = std::tanh(dot);
+    }
+}
+
+static void BM_SyncSGDEpochs(bench::State& state) {
+    // The single-threaded loop of Test.cpp, in mini-batches
+    MLP model(16, { 32, 32, 1 });
+    SGD optimizer(model, CONVERGENCE_LR);
+    std::shared_ptr<Tensor> X, Y;
+    teacher_data(X, Y);
+    const ParameterSpan span = model.parameter_span();
+    const std::vector<Scalar> initial(span.data, span.data + span.size);
+    double last = 0.0;
+
+    for (auto _ : state) {
+        std::copy(initial.begin(), initial.end(), span.data);
+        for (int e = 0; e < CONVERGENCE_EPOCHS; ++e) {
+            double sum = 0.0;
+            for (int r0 = 0; r0 < CONVERGENCE_ROWS; r0 += CONVERGENCE_BATCH) {
+                auto Xb = Tensor::from_data(CONVERGENCE_BATCH, 16,
+                    std::vector<Scalar>(X->data.begin() + (size_t)r0 * 16, X->data.begin() + (size_t)(r0 + CONVERGENCE_BATCH) * 16));
+                auto Yb = Tensor::from_data(CONVERGENCE_BATCH, 1,
+                    std::vector<Scalar>(Y->data.begin() + r0, Y->data.begin() + r0 + CONVERGENCE_BATCH));
+                auto loss = model(Xb)->sub(Yb)->pow(2)->sum();
+                optimizer.zero_grad();
+                loss->backward();
+                optimizer.step();
+                sum += loss->data[0];
+            }
+            last = sum / CONVERGENCE_ROWS;
+        }
+    }
+    state.counters["loss"] = last;
+    state.set_items_processed(state.iterations() * CONVERGENCE_EPOCHS * CONVERGENCE_ROWS);
+}
+BENCHMARK(BM_SyncSGDEpochs);
+
+static void BM_HogwildEpochs(bench::State& state) {
+    MLP model(16, { 32, 32, 1 });
+    HogwildTrainer trainer(model, CONVERGENCE_LR, (int)state.range(0), CONVERGENCE_BATCH);
+    std::shared_ptr<Tensor> X, Y;
+    teacher_data(X, Y);
+    const ParameterSpan span = model.parameter_span();
+    const std::vector<Scalar> initial(span.data, span.data + span.size);
+    double last = 0.0;
+
+    for (auto _ : state) {
+        std::copy(initial.begin(), initial.end(), span.data);
+        last = trainer.train(X, Y, CONVERGENCE_EPOCHS).loss.back();
+    }
+    state.counters["loss"] = last;
+    state.set_items_processed(state.iterations() * CONVERGENCE_EPOCHS * CONVERGENCE_ROWS);
+}
+BENCHMARK(BM_HogwildEpochs)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+// Scalar Value graph over 4 samples, SGD: rebuilt every step vs captured once
+
+static std::shared_ptr<Value> value_loss(MLP& model, std::vector<std::vector<std::shared_ptr<Value>>>& xs) {
+    auto loss = std::make_shared<Value>(0.0);
+    for (auto& x : xs) {
+        loss = loss + (model(x)[0] - std::make_shared<Value>(1.0))->pow(2);
+    }
+    return loss;
+}
+
+static std::vector<std::vector<std::shared_ptr<Value>>> value_inputs(int width) {
+    std::vector<std::vector<std::shared_ptr<Value>>> xs(4);
+    for (int s = 0; s < 4; ++s) {
+        for (int i = 0; i < width; ++i) {
+            xs[s].push_back(std::make_shared<Value>(0.01 * (s + i)));
+        }
+    }
+    return xs;
+}
+
+static void BM_ValueTrainStep(bench::State& state) {
+    const int width = (int)state.range(0);
+    MLP model(width, { width, width, 1 });
+    SGD optimizer(model, 1e-3);
+    auto xs = value_inputs(width);
+
+    for (auto _ : state) {
+        auto loss = value_loss(model, xs);
+        optimizer.zero_grad();
+        loss->backward();
+        optimizer.step();
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_ValueTrainStep)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_CapturedTrainStep(bench::State& state) {
+    const int width = (int)state.range(0);
+    MLP model(width, { width, width, 1 });
+    SGD optimizer(model, 1e-3);
+    auto xs = value_inputs(width);
+    CapturedGraph graph(value_loss(model, xs));
+
+    for (auto _ : state) {
+        graph.forward();
+        optimizer.zero_grad();
+        graph.backward();
+        optimizer.step();
+    }
+    state.counters["instructions"] = (double)graph.num_instructions();
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_CapturedTrainStep)->Arg(4)->Arg(16)->Arg(64);
+
+// Hashed sparse inputs: batch of 32 rows, 50 non-zeros each, out of arg 0
+// dimensions; SparseLinear(dim, 16) into MLP(16, {16, 1}), SGD. The cost
+// should not depend on the dimension.
+static void BM_SparseTrainStep(bench::State& state) {
+    const int dim = (int)state.range(0), batch = 32, nnz = 50;
+    SparseLinear embed(dim, 16);
+    MLP head(16, { 16, 1 });
+    SGD optimizer(head, 1e-3);
+    SparseBatch X(dim);
+    std::uniform_int_distribution<int32_t> feature(0, dim - 1);
+    std::vector<int32_t> idx(nnz);
+    std::vector<Scalar> val(nnz, 1.0);
+    for (int r = 0; r < batch; ++r) {
+        for (auto& i : idx) i = feature(rng);
+        X.add_row(idx.data(), val.data(), nnz);
+    }
+    auto Y = random_tensor(batch, 1);
+
+    for (auto _ : state) {
+        auto loss = head(embed(X))->sub(Y)->pow(2)->sum();
+        optimizer.zero_grad();
+        embed.zero_grad();
+        loss->backward();
+        optimizer.step();
+        embed.sgd_step(1e-3);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_SparseTrainStep)->Arg(1 << 17)->Arg(1 << 20);
+
+// ----------------------------------------------------------------------
+// 5. Input pipeline: one epoch of 65536 records (16 inputs, 1 target)
+// ----------------------------------------------------------------------
+// Arg 0 = CSV, 1 = float32 binary; 4096-record shuffle window, batches of 256
+
+static void BM_DataLoaderEpoch(bench::State& state) {
+    const int rows = 65536, nin = 16;
+    const bool binary = state.range(0) == 1;
+
+    // The fixture goes to the temporary directory, so the suite also runs
+    // from a read-only working directory
+    std::error_code ec;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+    if (ec) {
+        state.skip_with_error("no temporary directory: " + ec.message());
+        return;
+    }
+    const std::string path = (dir / (binary ? "microgradcpp_bench_data.bin" : "microgradcpp_bench_data.csv")).string();
+
+    std::uniform_real_distribution<> dis(-1.0, 1.0);
+    std::FILE* f = std::fopen(path.c_str(), binary ? "wb" : "w");
+    if (!f) {
+        state.skip_with_error("cannot write " + path);
+        return;
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c <= nin; ++c) {
+            float v = (float)dis(rng);
+            if (binary) std::fwrite(&v, sizeof(float), 1, f);
+            else std::fprintf(f, c < nin ? "%.6f," : "%.6f\n", v);
+        }
+    }
+    if (std::fclose(f) != 0) {
+        std::remove(path.c_str());
+        state.skip_with_error("cannot write " + path);
+        return;
+    }
+
+    std::unique_ptr<RecordSource> source;
+    if (binary) source = std::make_unique<BinarySource>(path, nin, 1);
+    else source = std::make_unique<CsvSource>(path, nin, 1);
+    DataLoader loader(std::move(source), 256, 4096);
+    Batch batch;
+
+    for (auto _ : state) {
+        while (loader.next(batch)) {
+            bench::do_not_optimize(batch.x[0]);
+        }
+        loader.reset();
+    }
+    std::remove(path.c_str());
+    state.set_items_processed(state.iterations() * rows);
+}
+BENCHMARK(BM_DataLoaderEpoch)->Arg(0)->Arg(1);
+
+// ----------------------------------------------------------------------
+// 6. Serving: 16 clients, 64 requests each per iteration, MLP(64, {64, 64, 1})
+// ----------------------------------------------------------------------
+// Args: max batch, max delay in microseconds
+
+static void BM_InferenceServer(bench::State& state) {
+    const int width = 64, clients = 16, requests = 64;
+    MLP model(width, { width, width, 1 });
+    InferenceServer server(model, { 0, (int)state.range(0), (int)state.range(1) });
+    std::vector<std::unique_ptr<InferenceClient>> connections;
+    for (int c = 0; c < clients; ++c) {
+        connections.push_back(std::make_unique<InferenceClient>(server.port()));
+    }
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (int c = 0; c < clients; ++c) {
+            threads.emplace_back([&, c]() {
+                std::vector<float> x(width, 0.01f * c), out;
+                for (int r = 0; r < requests; ++r) {
+                    connections[c]->predict(x, out);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    const ServerStats stats = server.stats();
+    state.counters["mean_batch"] = stats.mean_batch;
+    state.counters["p50_us"] = stats.p50_us;
+    state.counters["p99_us"] = stats.p99_us;
+    state.set_items_processed(state.iterations() * clients * requests);
+}
+BENCHMARK(BM_InferenceServer)->Args({ 1, 0 })->Args({ 16, 100 })->Args({ 16, 1000 })->Args({ 64, 1000 });
+
+int main(int argc, char** argv) {
+    return bench::run(argc, argv);
+}
\ No newline at end of file
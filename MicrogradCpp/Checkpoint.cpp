@@ -0,0 +1,173 @@
+#include "Checkpoint.h"
+#include "Layer.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char CHECKPOINT_MAGIC[8] = { 'M', 'G', 'R', 'A', 'D', 'C', 'K', 'P' };
+static const uint32_t CHECKPOINT_ENDIAN = 0x01020304;
+
+static uint64_t blob_offset_for(size_t num_layers) {
+    uint64_t end = sizeof(CheckpointHeader) + num_layers * sizeof(CheckpointLayer);
+    return (end + CHECKPOINT_ALIGN - 1) / CHECKPOINT_ALIGN * CHECKPOINT_ALIGN;
+}
+
+// --------------------------------------------------------------------------
+// SAVE
+// --------------------------------------------------------------------------
+
+void save_checkpoint(const std::string& path, int nin, const std::vector<CheckpointLayer>& layers,
+                     const Scalar* params, size_t num_params) {
+    CheckpointHeader h{};
+    std::memcpy(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic));
+    h.version = CHECKPOINT_VERSION;
+    h.endian = CHECKPOINT_ENDIAN;
+    h.scalar_size = sizeof(Scalar);
+    h.nin = (uint32_t)nin;
+    h.num_layers = (uint32_t)layers.size();
+    h.num_params = num_params;
+    h.blob_offset = blob_offset_for(layers.size());
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) throw std::runtime_error("checkpoint: cannot open " + path + " for writing");
+
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(layers.data()), layers.size() * sizeof(CheckpointLayer));
+
+    const char zeros[CHECKPOINT_ALIGN] = {};
+    size_t written = sizeof(h) + layers.size() * sizeof(CheckpointLayer);
+    f.write(zeros, h.blob_offset - written);
+
+    f.write(reinterpret_cast<const char*>(params), num_params * sizeof(Scalar));
+    if (!f) throw std::runtime_error("checkpoint: write to " + path + " failed");
+}
+
+// --------------------------------------------------------------------------
+// MAPPED MODEL
+// --------------------------------------------------------------------------
+
+// 1. Constructor: map the file, then validate it in place
+MappedModel::MappedModel(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("checkpoint: cannot open " + path);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("checkpoint: cannot read size of " + path);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* base = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!base) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("checkpoint: cannot map " + path);
+    }
+    _file = file;
+    _mapping = mapping;
+    _base = base;
+    _size = (size_t)size.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("checkpoint: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("checkpoint: cannot read size of " + path);
+    }
+    void* base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (base == MAP_FAILED) throw std::runtime_error("checkpoint: cannot map " + path);
+    _base = base;
+    _size = (size_t)st.st_size;
+#endif
+
+    const char* bytes = static_cast<const char*>(_base);
+    CheckpointHeader h;
+    const char* error = nullptr;
+    if (_size < sizeof(h)) {
+        error = "file too small";
+    } else {
+        std::memcpy(&h, bytes, sizeof(h));
+        if (std::memcmp(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic)) != 0) error = "not a checkpoint";
+        else if (h.version != CHECKPOINT_VERSION) error = "unsupported version";
+        else if (h.endian != CHECKPOINT_ENDIAN) error = "written on a machine with different byte order";
+        else if (h.scalar_size != sizeof(Scalar)) error = "unsupported scalar size";
+        else if (h.num_layers == 0 || h.blob_offset != blob_offset_for(h.num_layers)) error = "corrupt header";
+        else if (h.blob_offset > _size || h.num_params > (_size - h.blob_offset) / sizeof(Scalar)) error = "truncated";
+    }
+
+    if (!error) {
+        _layers.resize(h.num_layers);
+        std::memcpy(_layers.data(), bytes + sizeof(h), h.num_layers * sizeof(CheckpointLayer));
+
+        // The blob must hold exactly the parameters the architecture needs
+        uint64_t expected = 0;
+        uint64_t fan_in = h.nin;
+        for (const CheckpointLayer& l : _layers) {
+            expected += (uint64_t)l.nout * (fan_in + 1);
+            fan_in = l.nout;
+        }
+        if (expected != h.num_params) error = "parameter count does not match the architecture";
+    }
+
+    if (error) {
+        unmap();
+        throw std::runtime_error("checkpoint: " + path + ": " + error);
+    }
+
+    _nin = (int)h.nin;
+    _params = reinterpret_cast<const Scalar*>(bytes + h.blob_offset);
+    _num_params = (size_t)h.num_params;
+}
+
+// 2. Destructor
+MappedModel::~MappedModel() {
+    unmap();
+}
+
+void MappedModel::unmap() {
+    if (!_base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(_base);
+    CloseHandle((HANDLE)_mapping);
+    CloseHandle((HANDLE)_file);
+#else
+    munmap(_base, _size);
+#endif
+    _base = nullptr;
+}
+
+// 3. Inference (no graph)
+void MappedModel::predict(const Scalar* x, Scalar* out) const {
+    // Ping-pong buffers for the hidden activations, reused across calls
+    static thread_local std::vector<Scalar> buf[2];
+
+    const Scalar* in = x;
+    const Scalar* p = _params;
+    int fan_in = _nin;
+    for (size_t l = 0; l < _layers.size(); ++l) {
+        const int nout = (int)_layers[l].nout;
+        Scalar* dst = out;
+        if (l + 1 < _layers.size()) {
+            std::vector<Scalar>& b = buf[l % 2];
+            if (b.size() < (size_t)nout) b.resize(nout);
+            dst = b.data();
+        }
+        Layer::predict(p, fan_in, nout, _layers[l].nonlin != 0, in, dst);
+        p += (size_t)nout * (fan_in + 1);
+        fan_in = nout;
+        in = dst;
+    }
+}
\ No newline at end of file
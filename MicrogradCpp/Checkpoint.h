@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Scalar.h"
+
+// --------------------------------------------------------------------------
+// CHECKPOINTS
+// --------------------------------------------------------------------------
+// Versioned binary file holding an MLP's architecture and its flat
+// parameter storage (Module::parameter_span()), little-endian:
+//
+//     CheckpointHeader               64 bytes
+//     CheckpointLayer[num_layers]     8 bytes each
+//     zero padding                   up to blob_offset (multiple of 64)
+//     Scalar[num_params]             [w..., b] per neuron, parameters() order
+//
+// Because the blob is aligned and already in the in-memory layout,
+// MappedModel can mmap the file and run inference straight from the
+// mapped pages: loading costs no reads or copies, and every process that
+// maps the same file shares one physical copy of the weights.
+//
+//     model.save("model.mgc");
+//     MappedModel m("model.mgc");
+//     m.predict(x, out);
+//
+// Functions here throw std::runtime_error on I/O errors or invalid files.
+
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+constexpr uint32_t CHECKPOINT_ALIGN = 64;
+
+struct CheckpointHeader {
+    char magic[8];        // "MGRADCKP"
+    uint32_t version;     // CHECKPOINT_VERSION
+    uint32_t endian;      // 0x01020304 as written by the saving machine
+    uint32_t scalar_size; // sizeof(Scalar)
+    uint32_t nin;         // inputs to the first layer
+    uint32_t num_layers;
+    uint32_t reserved;
+    uint64_t num_params;  // Scalars in the blob
+    uint64_t blob_offset; // byte offset of the blob, CHECKPOINT_ALIGN aligned
+    uint8_t pad[16];
+};
+static_assert(sizeof(CheckpointHeader) == 64, "CheckpointHeader must stay 64 bytes");
+
+struct CheckpointLayer {
+    uint32_t nout;
+    uint32_t nonlin; // 1 = ReLU
+};
+
+// Writes a checkpoint for a network with the given architecture.
+// params holds the layers' parameters back to back, num_params Scalars.
+void save_checkpoint(const std::string& path, int nin, const std::vector<CheckpointLayer>& layers,
+                     const Scalar* params, size_t num_params);
+
+// Read-only view of a checkpoint mapped into memory
+class MappedModel {
+  public:
+    explicit MappedModel(const std::string& path);
+    ~MappedModel();
+
+    MappedModel(const MappedModel&) = delete;
+    MappedModel& operator=(const MappedModel&) = delete;
+
+    int nin() const { return _nin; }
+    int nout() const { return (int)_layers.back().nout; }
+    const std::vector<CheckpointLayer>& layers() const { return _layers; }
+
+    // The mapped blob: num_parameters() Scalars in parameters() order
+    const Scalar* parameters() const { return _params; }
+    size_t num_parameters() const { return _num_params; }
+
+    // Inference only, same math as MLP::predict: nin() values in, nout() out.
+    // No heap allocation once the calling thread has run it once.
+    void predict(const Scalar* x, Scalar* out) const;
+
+  private:
+    int _nin = 0;
+    std::vector<CheckpointLayer> _layers;
+    const Scalar* _params = nullptr;
+    size_t _num_params = 0;
+
+    void* _base = nullptr; // start of the mapping
+    size_t _size = 0;      // bytes mapped
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+
+    void unmap();
+};
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "DataLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+static const size_t CHUNK_BYTES = 1 << 20;
+
+static std::FILE* open_or_throw(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) throw std::runtime_error("data: cannot open " + path);
+    return f;
+}
+
+// --------------------------------------------------------------------------
+// CSV
+// --------------------------------------------------------------------------
+
+CsvSource::CsvSource(const std::string& path, int nin, int nout, bool skip_header)
+    : RecordSource(nin, nout), _path(path), _file(open_or_throw(path)), _skip_header(skip_header),
+      _buf(CHUNK_BYTES + 1)
+{
+    rewind();
+}
+
+CsvSource::~CsvSource() {
+    if (_file) std::fclose(_file);
+}
+
+void CsvSource::rewind() {
+    std::rewind(_file);
+    _pos = _end = 0;
+    _buf[0] = '\0';
+    _eof = false;
+    _line = 0;
+
+    char* begin;
+    char* end;
+    if (_skip_header) next_line(begin, end);
+}
+
+// Finds the next line in the buffer, reading more of the file when the line
+// is not complete yet. The line is [begin, end), followed by '\n' or NUL.
+bool CsvSource::next_line(char*& begin, char*& end) {
+    for (;;) {
+        char* p = _buf.data() + _pos;
+        char* nl = static_cast<char*>(std::memchr(p, '\n', _end - _pos));
+        if (nl || (_eof && _pos < _end)) {
+            begin = p;
+            end = nl ? nl : _buf.data() + _end;
+            _pos = nl ? (size_t)(nl - _buf.data()) + 1 : _end;
+            ++_line;
+            return true;
+        }
+        if (_eof) return false;
+
+        // Keep the partial line, refill behind it (growing for very long lines)
+        size_t left = _end - _pos;
+        std::memmove(_buf.data(), p, left);
+        _pos = 0;
+        _end = left;
+        if (_buf.size() - 1 - _end < CHUNK_BYTES / 2) _buf.resize(_buf.size() * 2);
+        size_t got = std::fread(_buf.data() + _end, 1, _buf.size() - 1 - _end, _file);
+        if (got == 0) {
+            if (std::ferror(_file)) throw std::runtime_error("data: read from " + _path + " failed");
+            _eof = true;
+        }
+        _end += got;
+        _buf[_end] = '\0'; // strtod never runs past the data
+    }
+}
+
+bool CsvSource::next(Scalar* x, Scalar* y) {
+    char* begin;
+    char* end;
+    for (;;) {
+        if (!next_line(begin, end)) return false;
+        while (begin < end && std::isspace((unsigned char)*begin)) ++begin;
+        if (begin < end) break; // skip blank lines
+    }
+
+    const int n = nin + nout;
+    char* p = begin;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0) {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+            if (p == end || *p != ',') p = nullptr;
+            else ++p;
+        }
+        char* q = p;
+        Scalar v = p ? std::strtod(p, &q) : 0.0;
+        if (!p || q == p || q > end) {
+            throw std::runtime_error("data: " + _path + " line " + std::to_string(_line) +
+                                     ": expected " + std::to_string(n) + " numbers");
+        }
+        (i < nin ? x[i] : y[i - nin]) = v;
+        p = q;
+    }
+    while (p < end && std::isspace((unsigned char)*p)) ++p;
+    if (p != end) {
+        throw std::runtime_error("data: " + _path + " line " + std::to_string(_line) +
+                                 ": more than " + std::to_string(n) + " numbers");
+    }
+    return true;
+}
+
+// --------------------------------------------------------------------------
+// BINARY
+// --------------------------------------------------------------------------
+
+BinarySource::BinarySource(const std::string& path, int nin, int nout)
+    : RecordSource(nin, nout), _path(path), _file(open_or_throw(path))
+{
+    const size_t rec = (size_t)(nin + nout);
+    _buf.resize(std::max<size_t>(1, CHUNK_BYTES / (rec * sizeof(float))) * rec);
+}
+
+BinarySource::~BinarySource() {
+    if (_file) std::fclose(_file);
+}
+
+void BinarySource::rewind() {
+    std::rewind(_file);
+    _pos = _end = 0;
+}
+
+bool BinarySource::next(Scalar* x, Scalar* y) {
+    const size_t rec = (size_t)(nin + nout);
+    if (_pos == _end) {
+        size_t got = std::fread(_buf.data(), sizeof(float), _buf.size(), _file);
+        if (got % rec != 0) throw std::runtime_error("data: " + _path + " ends inside a record");
+        if (got == 0 && std::ferror(_file)) throw std::runtime_error("data: read from " + _path + " failed");
+        _pos = 0;
+        _end = got;
+        if (got == 0) return false;
+    }
+
+    const float* r = _buf.data() + _pos;
+    for (int i = 0; i < nin; ++i) x[i] = r[i];
+    for (int i = 0; i < nout; ++i) y[i] = r[nin + i];
+    _pos += rec;
+    return true;
+}
+
+// --------------------------------------------------------------------------
+// BATCH
+// --------------------------------------------------------------------------
+
+std::shared_ptr<Tensor> Batch::inputs() const {
+    return Tensor::from_data(rows, nin, std::vector<Scalar>(x.begin(), x.begin() + (size_t)rows * nin));
+}
+
+std::shared_ptr<Tensor> Batch::targets() const {
+    return Tensor::from_data(rows, nout, std::vector<Scalar>(y.begin(), y.begin() + (size_t)rows * nout));
+}
+
+// --------------------------------------------------------------------------
+// LOADER
+// --------------------------------------------------------------------------
+
+DataLoader::DataLoader(std::unique_ptr<RecordSource> source, int batch_size, size_t shuffle_window,
+                       uint64_t seed, int prefetch)
+    : _source(std::move(source)), _batch_size(std::max(1, batch_size)),
+      _window(std::max<size_t>(1, shuffle_window)), _seed(seed), _prefetch(std::max(1, prefetch))
+{
+    start();
+}
+
+DataLoader::~DataLoader() {
+    halt();
+}
+
+void DataLoader::start() {
+    _done = false;
+    _stop = false;
+    _error = nullptr;
+    _producer = std::thread([this]() {
+        try {
+            produce();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+        }
+        _ready_cv.notify_all();
+        });
+}
+
+void DataLoader::halt() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _space_cv.notify_all();
+    if (_producer.joinable()) _producer.join();
+}
+
+void DataLoader::reset() {
+    halt();
+    for (Batch& b : _ready) {
+        _free.push_back(std::move(b));
+    }
+    _ready.clear();
+    _source->rewind();
+    ++_epoch;
+    start();
+}
+
+bool DataLoader::next(Batch& batch) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _ready_cv.wait(lock, [this]() { return !_ready.empty() || _done; });
+    if (_ready.empty()) {
+        if (_error) std::rethrow_exception(_error);
+        return false;
+    }
+
+    // Swap buffers: the caller's previous batch goes back to the producer
+    std::swap(batch, _ready.front());
+    if (_ready.front().x.capacity() > 0) _free.push_back(std::move(_ready.front()));
+    _ready.pop_front();
+    lock.unlock();
+    _space_cv.notify_one();
+    return true;
+}
+
+Batch DataLoader::take_free() {
+    Batch b;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free.empty()) {
+            b = std::move(_free.back());
+            _free.pop_back();
+        }
+    }
+    b.rows = 0;
+    b.nin = _source->nin;
+    b.nout = _source->nout;
+    b.x.resize((size_t)_batch_size * b.nin);
+    b.y.resize((size_t)_batch_size * b.nout);
+    return b;
+}
+
+// Queues a finished batch, waiting while the queue is full; false on stop
+bool DataLoader::publish(Batch& batch) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _space_cv.wait(lock, [this]() { return (int)_ready.size() < _prefetch || _stop; });
+    if (_stop) return false;
+    _ready.push_back(std::move(batch));
+    lock.unlock();
+    _ready_cv.notify_one();
+    return true;
+}
+
+// Runs on the background thread: one epoch of the source into batches
+void DataLoader::produce() {
+    const int nin = _source->nin, nout = _source->nout;
+    const size_t rec = (size_t)(nin + nout);
+    std::mt19937_64 rng(_seed + _epoch);
+
+    // Shuffle window: once it is full, every new record replaces a random
+    // held one, which is emitted. Records travel at most ~window positions.
+    std::vector<Scalar> window(_window * rec);
+    size_t held = 0;
+
+    Batch batch = take_free();
+    auto emit = [&](const Scalar* r) {
+        const size_t row = (size_t)batch.rows++;
+        std::copy(r, r + nin, batch.x.data() + row * nin);
+        std::copy(r + nin, r + rec, batch.y.data() + row * nout);
+        if (batch.rows < _batch_size) return true;
+        if (!publish(batch)) return false;
+        batch = take_free();
+        return true;
+    };
+
+    for (;;) {
+        if (_stop) return;
+        if (held < _window) {
+            Scalar* slot = window.data() + held * rec;
+            if (!_source->next(slot, slot + nin)) break;
+            ++held;
+            continue;
+        }
+        Scalar* slot = window.data() + (size_t)(rng() % held) * rec;
+        if (!emit(slot)) return;
+        if (!_source->next(slot, slot + nin)) {
+            // Emitted record leaves a hole: fill it with the last one
+            std::copy(window.data() + (held - 1) * rec, window.data() + held * rec, slot);
+            --held;
+            break;
+        }
+    }
+
+    // End of data: drain what is left in random order
+    while (held > 0) {
+        Scalar* slot = window.data() + (size_t)(rng() % held) * rec;
+        if (!emit(slot)) return;
+        std::copy(window.data() + (held - 1) * rec, window.data() + held * rec, slot);
+        --held;
+    }
+    if (batch.rows > 0) publish(batch);
+}
\ No newline at end of file
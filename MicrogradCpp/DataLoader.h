@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Tensor.h"
+
+// --------------------------------------------------------------------------
+// DATA LOADER
+// --------------------------------------------------------------------------
+// Streams (input, target) records from a file into contiguous mini-batches.
+// The file is read in fixed-size chunks, never loaded whole, so it can be
+// larger than memory. A background thread reads, parses, shuffles and packs
+// the next batches while the caller trains on the current one.
+//
+//     DataLoader loader(std::make_unique<CsvSource>("train.csv", 8, 1), 256, 4096);
+//     Batch batch;
+//     for (int epoch = 0; epoch < epochs; ++epoch) {
+//         while (loader.next(batch)) {
+//             auto loss = model(batch.inputs())->sub(batch.targets())->pow(2)->sum();
+//             ...
+//         }
+//         loader.reset(); // rewind for the next epoch
+//     }
+//
+// Sources and the loader throw std::runtime_error on I/O or parse errors;
+// an error on the background thread is rethrown by the next call to next().
+
+// A sequential reader of fixed-width records: nin inputs followed by nout targets
+struct RecordSource {
+    int nin;
+    int nout;
+
+    RecordSource(int nin, int nout) : nin(nin), nout(nout) {}
+    virtual ~RecordSource() = default;
+
+    // Reads the next record into x[0 .. nin) and y[0 .. nout); false at end of data
+    virtual bool next(Scalar* x, Scalar* y) = 0;
+
+    // Start again from the first record
+    virtual void rewind() = 0;
+};
+
+// Text file, one record per line: nin + nout numbers separated by commas.
+// Blank lines are skipped; skip_header drops the first line.
+struct CsvSource : public RecordSource {
+    CsvSource(const std::string& path, int nin, int nout, bool skip_header = false);
+    ~CsvSource() override;
+
+    bool next(Scalar* x, Scalar* y) override;
+    void rewind() override;
+
+  private:
+    std::string _path;
+    std::FILE* _file = nullptr;
+    bool _skip_header;
+    std::vector<char> _buf; // [_pos, _end) not yet parsed, NUL at _end
+    size_t _pos = 0;
+    size_t _end = 0;
+    bool _eof = false;
+    size_t _line = 0;
+
+    bool next_line(char*& begin, char*& end);
+};
+
+// Raw binary file of float32 records, nin + nout values each, native byte order
+struct BinarySource : public RecordSource {
+    BinarySource(const std::string& path, int nin, int nout);
+    ~BinarySource() override;
+
+    bool next(Scalar* x, Scalar* y) override;
+    void rewind() override;
+
+  private:
+    std::string _path;
+    std::FILE* _file = nullptr;
+    std::vector<float> _buf; // whole records only
+    size_t _pos = 0;
+    size_t _end = 0;
+};
+
+// One mini-batch, row-major. The buffers are recycled between batches, so
+// they may be larger than rows * nin; only the first 'rows' rows are valid.
+struct Batch {
+    int rows = 0;
+    int nin = 0;
+    int nout = 0;
+    std::vector<Scalar> x; // rows x nin
+    std::vector<Scalar> y; // rows x nout
+
+    // Copies of the valid rows as graph leaves
+    std::shared_ptr<Tensor> inputs() const;
+    std::shared_ptr<Tensor> targets() const;
+};
+
+class DataLoader {
+  public:
+    // batch_size:     rows per batch; the last batch of an epoch may be smaller
+    // shuffle_window: records held back and emitted in random order (0 or 1 = file order).
+    //                 Memory is shuffle_window * (nin + nout) Scalars.
+    // prefetch:       finished batches queued ahead of the consumer
+    DataLoader(std::unique_ptr<RecordSource> source, int batch_size, size_t shuffle_window = 0,
+               uint64_t seed = 0, int prefetch = 2);
+    ~DataLoader();
+
+    DataLoader(const DataLoader&) = delete;
+    DataLoader& operator=(const DataLoader&) = delete;
+
+    // Hands over the next batch of the epoch, taking batch's old buffers
+    // back for reuse. Blocks until one is ready; false once the epoch is done.
+    bool next(Batch& batch);
+
+    // Starts the next epoch from the beginning of the source (new shuffle order)
+    void reset();
+
+  private:
+    std::unique_ptr<RecordSource> _source;
+    int _batch_size;
+    size_t _window;
+    uint64_t _seed;
+    int _prefetch;
+    uint64_t _epoch = 0;
+
+    std::thread _producer;
+    std::mutex _mutex;
+    std::condition_variable _ready_cv; // a batch was queued, or the epoch ended
+    std::condition_variable _space_cv; // the queue has room, or stop
+    std::deque<Batch> _ready;
+    std::vector<Batch> _free;
+    bool _done = false;
+    std::atomic<bool> _stop{ false }; // read by the producer between records
+    std::exception_ptr _error;
+
+    void start();
+    void halt();
+    void produce();
+    Batch take_free();
+    bool publish(Batch& batch);
+};
\ No newline at end of file
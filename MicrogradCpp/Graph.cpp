@@ -0,0 +1,143 @@
+#include "Graph.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+// 1. Capture
+CapturedGraph::CapturedGraph(const std::shared_ptr<Value>& root) {
+    std::vector<Value*> topo;
+    root->build_topo(topo);
+
+    // Slot numbers follow the topological order
+    const int32_t n = (int32_t)topo.size();
+    std::unordered_map<const Value*, int32_t> slot;
+    slot.reserve(n);
+    size_t interior = 0;
+    for (int32_t i = 0; i < n; ++i) {
+        slot[topo[i]] = i;
+        if (!topo[i]->_prev.empty()) ++interior;
+    }
+
+    // Sized once, so the slot pointers below stay valid
+    _data.assign(interior, 0.0);
+    _grad.assign(interior, 0.0);
+    _d.resize(n);
+    _g.resize(n);
+
+    size_t next = 0;
+    for (int32_t i = 0; i < n; ++i) {
+        Value* v = topo[i];
+        if (v->_prev.empty()) {
+            _d[i] = &v->data;
+            _g[i] = &v->grad;
+            _leaves.push_back(v->shared_from_this());
+            continue;
+        }
+
+        _d[i] = &_data[next];
+        _g[i] = &_grad[next];
+        _data[next] = v->data;
+        ++next;
+
+        Instr ins{ v->op, v->_act, i, -1, -1, v->_aux };
+        const auto& p = v->_prev;
+        if (v->op == Op::DotBiasAct) {
+            ins.lhs = (int32_t)_args.size();
+            ins.rhs = (int32_t)((p.size() - 1) / 2);
+            for (auto& child : p) {
+                _args.push_back(slot[child.get()]);
+            }
+        }
+        else {
+            ins.lhs = slot[p[0].get()];
+            if (p.size() > 1) ins.rhs = slot[p[1].get()];
+        }
+        _code.push_back(ins);
+    }
+    _root = n - 1; // the root is last in post-order
+}
+
+// 2. Forward
+Scalar CapturedGraph::forward() {
+    Scalar* const* d = _d.data();
+    const int32_t* args = _args.data();
+
+    for (const Instr& ins : _code) {
+        Scalar& out = *d[ins.out];
+        switch (ins.op) {
+        case Op::Leaf: break;
+        case Op::Add:  out = *d[ins.lhs] + *d[ins.rhs]; break;
+        case Op::Mul:  out = *d[ins.lhs] * *d[ins.rhs]; break;
+        case Op::Pow:  out = std::pow(*d[ins.lhs], ins.aux); break;
+        case Op::ReLU: out = *d[ins.lhs] < 0 ? 0.0 : *d[ins.lhs]; break;
+        case Op::Tanh: out = std::tanh(*d[ins.lhs]); break;
+        case Op::Exp:  out = std::exp(*d[ins.lhs]); break;
+        case Op::DotBiasAct: {
+            const int32_t* w = args + ins.lhs;
+            const int32_t* x = w + ins.rhs;
+            Scalar a = *d[x[ins.rhs]]; // bias
+            for (int32_t k = 0; k < ins.rhs; ++k) {
+                a += *d[w[k]] * *d[x[k]];
+            }
+            if (ins.act == Act::ReLU) a = a < 0 ? 0.0 : a;
+            if (ins.act == Act::Tanh) a = std::tanh(a);
+            out = a;
+            break;
+        }
+        }
+    }
+    return *d[_root];
+}
+
+// 3. Backward
+void CapturedGraph::backward() {
+    Scalar* const* d = _d.data();
+    Scalar* const* g = _g.data();
+    const int32_t* args = _args.data();
+
+    std::fill(_grad.begin(), _grad.end(), 0.0);
+    *g[_root] = 1.0;
+
+    for (auto it = _code.rbegin(); it != _code.rend(); ++it) {
+        const Instr& ins = *it;
+        const Scalar gout = *g[ins.out];
+        const Scalar out = *d[ins.out];
+        switch (ins.op) {
+        case Op::Leaf: break;
+        case Op::Add:
+            *g[ins.lhs] += gout;
+            *g[ins.rhs] += gout;
+            break;
+        case Op::Mul:
+            *g[ins.lhs] += *d[ins.rhs] * gout;
+            *g[ins.rhs] += *d[ins.lhs] * gout;
+            break;
+        case Op::Pow:
+            *g[ins.lhs] += ins.aux * std::pow(*d[ins.lhs], ins.aux - 1.0) * gout;
+            break;
+        case Op::ReLU:
+            *g[ins.lhs] += (out > 0 ? 1.0 : 0.0) * gout;
+            break;
+        case Op::Tanh:
+            *g[ins.lhs] += (1.0 - out * out) * gout;
+            break;
+        case Op::Exp:
+            *g[ins.lhs] += out * gout;
+            break;
+        case Op::DotBiasAct: {
+            Scalar ga = gout;
+            if (ins.act == Act::ReLU) ga *= out > 0 ? 1.0 : 0.0;
+            if (ins.act == Act::Tanh) ga *= 1.0 - out * out;
+
+            const int32_t* w = args + ins.lhs;
+            const int32_t* x = w + ins.rhs;
+            for (int32_t k = 0; k < ins.rhs; ++k) {
+                *g[w[k]] += *d[x[k]] * ga;
+                *g[x[k]] += *d[w[k]] * ga;
+            }
+            *g[x[ins.rhs]] += ga;
+            break;
+        }
+        }
+    }
+}
\ No newline at end of file
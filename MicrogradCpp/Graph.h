@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Op.h"
+#include "Value.h"
+
+// --------------------------------------------------------------------------
+// CAPTURED GRAPH
+// --------------------------------------------------------------------------
+// A training loop over fixed shapes rebuilds the same Value graph every
+// step: the same nodes, closures and topological sort. CapturedGraph
+// records that graph once, as a flat list of instructions in topological
+// order, and replays it without allocating anything.
+//
+// Interior nodes get preallocated data/grad slots. Leaves are not copied:
+// instructions read and accumulate through pointers to the leaf Values'
+// own data and grad, so
+//   - new inputs are written straight into the input Values (x[i]->data = ...),
+//   - parameter updates by an Optimizer are seen by the next forward(),
+//   - backward() adds into Value::grad (the module's ParameterStore).
+//
+//     auto loss = ...;                      // build once with Value ops
+//     CapturedGraph graph(loss);
+//     for (...) {
+//         x[i]->data = ...;                 // new inputs
+//         graph.forward();
+//         optimizer.zero_grad();
+//         graph.backward();
+//         optimizer.step();
+//     }
+//
+// The graph keeps its leaf Values alive; the interior Values can be dropped.
+
+struct Instr {
+    Op op;
+    Act act;         // DotBiasAct
+    int32_t out;     // slot written
+    int32_t lhs;     // first operand slot. DotBiasAct: offset of its operands in 'args'
+    int32_t rhs;     // second operand slot (-1 if none). DotBiasAct: n
+    Scalar aux;      // Pow: exponent
+};
+
+struct CapturedGraph {
+    // Record the graph ending at root
+    explicit CapturedGraph(const std::shared_ptr<Value>& root);
+
+    // Recompute every interior node from the current leaf data; returns the root's data
+    Scalar forward();
+
+    // Backpropagate from the root (grad 1) using the data of the last forward().
+    // Leaf gradients are ADDED to, like Value::backward().
+    void backward();
+
+    // Number of graph nodes / instructions
+    size_t num_nodes() const { return _d.size(); }
+    size_t num_instructions() const { return _code.size(); }
+
+  private:
+    std::vector<Instr> _code;    // non-leaf nodes, children first
+    std::vector<int32_t> _args;  // DotBiasAct operands: [w..., x..., b] slot lists
+    std::vector<Scalar*> _d;     // data pointer per slot
+    std::vector<Scalar*> _g;     // grad pointer per slot
+    std::vector<Scalar> _data;   // storage for interior slots
+    std::vector<Scalar> _grad;
+    int32_t _root = 0;
+
+    std::vector<std::shared_ptr<Value>> _leaves; // keeps the leaf storage alive
+};
\ No newline at end of file
@@ -0,0 +1,477 @@
+#include "Kernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+#define MG_INT8_AVX512_VNNI 1
+#elif defined(__AVXVNNI__)
+#define MG_INT8_AVX_VNNI 1
+#endif
+
+// --------------------------------------------------------------------------
+// SIMD PRIMITIVES
+// --------------------------------------------------------------------------
+// A handful of wrappers so every kernel below is written once and compiled
+// for whichever vector width and Scalar type are available.
+// MG_W = Scalars per vector.
+
+#if defined(__AVX512F__) && defined(MICROGRAD_FLOAT)
+#define MG_SIMD 1
+#define MG_W 16
+typedef __m512 vec;
+static inline vec vload(const Scalar* p) { return _mm512_loadu_ps(p); }
+static inline void vstore(Scalar* p, vec v) { _mm512_storeu_ps(p, v); }
+static inline vec vset1(Scalar a) { return _mm512_set1_ps(a); }
+static inline vec vzero() { return _mm512_setzero_ps(); }
+static inline vec vadd(vec a, vec b) { return _mm512_add_ps(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm512_max_ps(a, b); }
+static inline vec vdiv(vec a, vec b) { return _mm512_div_ps(a, b); }
+static inline vec vsqrt(vec a) { return _mm512_sqrt_ps(a); }
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+// Halves taken with the zero-masked extracts: in GCC 12 the reductions,
+// the plain extracts and the 512 -> 256 casts all start from an
+// _mm256_undefined_* value and trip -W(maybe-)uninitialized
+static inline Scalar vsum(vec v) {
+    __m512d d = _mm512_castps_pd(v);
+    __m256 h = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 0)),
+                             _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 1)));
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+}
+// g where y > 0, else 0
+static inline vec vpositive(vec y, vec g) {
+    return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(y, vzero(), _CMP_GT_OQ), g);
+}
+
+#elif defined(__AVX512F__)
+#define MG_SIMD 1
+#define MG_W 8
+typedef __m512d vec;
+static inline vec vload(const Scalar* p) { return _mm512_loadu_pd(p); }
+static inline void vstore(Scalar* p, vec v) { _mm512_storeu_pd(p, v); }
+static inline vec vset1(Scalar a) { return _mm512_set1_pd(a); }
+static inline vec vzero() { return _mm512_setzero_pd(); }
+static inline vec vadd(vec a, vec b) { return _mm512_add_pd(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm512_max_pd(a, b); }
+static inline vec vdiv(vec a, vec b) { return _mm512_div_pd(a, b); }
+static inline vec vsqrt(vec a) { return _mm512_sqrt_pd(a); }
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+// Halves taken with the zero-masked extracts (see the float version)
+static inline Scalar vsum(vec v) {
+    __m256d h = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, v, 0), _mm512_maskz_extractf64x4_pd(0xF, v, 1));
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(h), _mm256_extractf128_pd(h, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+static inline vec vpositive(vec y, vec g) {
+    return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(y, vzero(), _CMP_GT_OQ), g);
+}
+
+#elif defined(__AVX2__) && defined(MICROGRAD_FLOAT)
+#define MG_SIMD 1
+#define MG_W 8
+typedef __m256 vec;
+static inline vec vload(const Scalar* p) { return _mm256_loadu_ps(p); }
+static inline void vstore(Scalar* p, vec v) { _mm256_storeu_ps(p, v); }
+static inline vec vset1(Scalar a) { return _mm256_set1_ps(a); }
+static inline vec vzero() { return _mm256_setzero_ps(); }
+static inline vec vadd(vec a, vec b) { return _mm256_add_ps(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm256_max_ps(a, b); }
+static inline vec vdiv(vec a, vec b) { return _mm256_div_ps(a, b); }
+static inline vec vsqrt(vec a) { return _mm256_sqrt_ps(a); }
+#if defined(__FMA__) || defined(_MSC_VER)
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+static inline Scalar vsum(vec v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+}
+static inline vec vpositive(vec y, vec g) {
+    return _mm256_and_ps(_mm256_cmp_ps(y, vzero(), _CMP_GT_OQ), g);
+}
+
+#elif defined(__AVX2__)
+#define MG_SIMD 1
+#define MG_W 4
+typedef __m256d vec;
+static inline vec vload(const Scalar* p) { return _mm256_loadu_pd(p); }
+static inline void vstore(Scalar* p, vec v) { _mm256_storeu_pd(p, v); }
+static inline vec vset1(Scalar a) { return _mm256_set1_pd(a); }
+static inline vec vzero() { return _mm256_setzero_pd(); }
+static inline vec vadd(vec a, vec b) { return _mm256_add_pd(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm256_max_pd(a, b); }
+static inline vec vdiv(vec a, vec b) { return _mm256_div_pd(a, b); }
+static inline vec vsqrt(vec a) { return _mm256_sqrt_pd(a); }
+#if defined(__FMA__) || defined(_MSC_VER)
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+static inline vec vfmadd(vec a, vec b, vec c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+static inline Scalar vsum(vec v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+static inline vec vpositive(vec y, vec g) {
+    return _mm256_and_pd(_mm256_cmp_pd(y, vzero(), _CMP_GT_OQ), g);
+}
+#endif
+
+namespace kernels {
+
+    // Cache blocking for the GEMMs: a KC x NC panel of B (256 x 512 Scalars)
+    // is reused across every row of A before moving on.
+    static const int KC = 256;
+    static const int NC = 512;
+
+    const char* isa() {
+#if defined(__AVX512F__)
+        return "AVX-512";
+#elif defined(__AVX2__)
+        return "AVX2";
+#else
+        return "scalar";
+#endif
+    }
+
+    const char* isa_int8() {
+#if defined(MG_INT8_AVX512_VNNI)
+        return "AVX-512 VNNI";
+#elif defined(MG_INT8_AVX_VNNI)
+        return "AVX-VNNI";
+#elif defined(__AVX2__)
+        return "AVX2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void axpy(int n, Scalar a, const Scalar* x, Scalar* y) {
+        int i = 0;
+#ifdef MG_SIMD
+        vec va = vset1(a);
+        for (; i + MG_W <= n; i += MG_W) {
+            vstore(y + i, vfmadd(va, vload(x + i), vload(y + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            y[i] += a * x[i];
+        }
+    }
+
+    Scalar dot(int n, const Scalar* x, const Scalar* y) {
+        int i = 0;
+        Scalar s = 0.0;
+#ifdef MG_SIMD
+        // Two accumulators to hide FMA latency
+        vec s0 = vzero(), s1 = vzero();
+        for (; i + 2 * MG_W <= n; i += 2 * MG_W) {
+            s0 = vfmadd(vload(x + i), vload(y + i), s0);
+            s1 = vfmadd(vload(x + i + MG_W), vload(y + i + MG_W), s1);
+        }
+        for (; i + MG_W <= n; i += MG_W) {
+            s0 = vfmadd(vload(x + i), vload(y + i), s0);
+        }
+        s = vsum(vadd(s0, s1));
+#endif
+        for (; i < n; ++i) {
+            s += x[i] * y[i];
+        }
+        return s;
+    }
+
+    // C (MxN) += A * B, where A(i, k) = A[i * sa_i + k * sa_k].
+    // Shared body of gemm_nn and gemm_tn (which only differ in A's layout).
+    // ldb / ldc are the row strides of B / C.
+    //
+    // Rows of C are processed four at a time: a 4 x 2W tile of C stays in
+    // registers for the whole k loop and every load of B feeds four FMAs,
+    // so the cost per row drops as the batch (M) grows.
+    static void gemm_acc(int M, int N, int K, const Scalar* A, size_t sa_i, size_t sa_k,
+                         const Scalar* B, size_t ldb, Scalar* C, size_t ldc) {
+        for (int k0 = 0; k0 < K; k0 += KC) {
+            int k1 = std::min(K, k0 + KC);
+            for (int j0 = 0; j0 < N; j0 += NC) {
+                int j1 = std::min(N, j0 + NC);
+                int i = 0;
+#ifdef MG_SIMD
+                for (; i + 4 <= M; i += 4) {
+                    const Scalar* a0 = A + (size_t)i * sa_i;
+                    Scalar* c0 = C + (size_t)i * ldc;
+                    int j = j0;
+                    for (; j + 2 * MG_W <= j1; j += 2 * MG_W) {
+                        vec acc[4][2];
+                        for (int r = 0; r < 4; ++r) {
+                            acc[r][0] = vload(c0 + (size_t)r * ldc + j);
+                            acc[r][1] = vload(c0 + (size_t)r * ldc + j + MG_W);
+                        }
+                        for (int k = k0; k < k1; ++k) {
+                            const Scalar* b = B + (size_t)k * ldb + j;
+                            vec b0 = vload(b), b1 = vload(b + MG_W);
+                            for (int r = 0; r < 4; ++r) {
+                                vec a = vset1(a0[r * sa_i + k * sa_k]);
+                                acc[r][0] = vfmadd(a, b0, acc[r][0]);
+                                acc[r][1] = vfmadd(a, b1, acc[r][1]);
+                            }
+                        }
+                        for (int r = 0; r < 4; ++r) {
+                            vstore(c0 + (size_t)r * ldc + j, acc[r][0]);
+                            vstore(c0 + (size_t)r * ldc + j + MG_W, acc[r][1]);
+                        }
+                    }
+                    // Leftover columns of this 4-row block
+                    if (j < j1) {
+                        for (int r = 0; r < 4; ++r) {
+                            for (int k = k0; k < k1; ++k) {
+                                axpy(j1 - j, a0[r * sa_i + k * sa_k], B + (size_t)k * ldb + j, c0 + (size_t)r * ldc + j);
+                            }
+                        }
+                    }
+                }
+#endif
+                // Leftover rows (or every row without SIMD)
+                for (; i < M; ++i) {
+                    Scalar* c = C + (size_t)i * ldc + j0;
+                    for (int k = k0; k < k1; ++k) {
+                        axpy(j1 - j0, A[i * sa_i + k * sa_k], B + (size_t)k * ldb + j0, c);
+                    }
+                }
+            }
+        }
+    }
+
+    void gemm_nn(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb, int ldc) {
+        gemm_acc(M, N, K, A, (size_t)K, 1, B, (size_t)(ldb ? ldb : N), C, (size_t)(ldc ? ldc : N));
+    }
+
+    void gemm_tn(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb, int ldc) {
+        gemm_acc(M, N, K, A, 1, (size_t)M, B, (size_t)(ldb ? ldb : N), C, (size_t)(ldc ? ldc : N));
+    }
+
+    void gemm_nt(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb) {
+        const size_t lb = (size_t)(ldb ? ldb : K);
+        int i = 0;
+#ifdef MG_SIMD
+        // Four rows of A against one row of B: each load of B feeds four dots
+        for (; i + 4 <= M; i += 4) {
+            const Scalar* a = A + (size_t)i * K;
+            Scalar* c = C + (size_t)i * N;
+            for (int j = 0; j < N; ++j) {
+                const Scalar* b = B + (size_t)j * lb;
+                vec s0 = vzero(), s1 = vzero(), s2 = vzero(), s3 = vzero();
+                int k = 0;
+                for (; k + MG_W <= K; k += MG_W) {
+                    vec vb = vload(b + k);
+                    s0 = vfmadd(vload(a + k), vb, s0);
+                    s1 = vfmadd(vload(a + K + k), vb, s1);
+                    s2 = vfmadd(vload(a + 2 * (size_t)K + k), vb, s2);
+                    s3 = vfmadd(vload(a + 3 * (size_t)K + k), vb, s3);
+                }
+                Scalar t0 = vsum(s0), t1 = vsum(s1), t2 = vsum(s2), t3 = vsum(s3);
+                for (; k < K; ++k) {
+                    t0 += a[k] * b[k];
+                    t1 += a[K + k] * b[k];
+                    t2 += a[2 * (size_t)K + k] * b[k];
+                    t3 += a[3 * (size_t)K + k] * b[k];
+                }
+                c[j] += t0;
+                c[N + j] += t1;
+                c[2 * (size_t)N + j] += t2;
+                c[3 * (size_t)N + j] += t3;
+            }
+        }
+#endif
+        for (; i < M; ++i) {
+            const Scalar* a = A + (size_t)i * K;
+            Scalar* c = C + (size_t)i * N;
+            for (int j = 0; j < N; ++j) {
+                c[j] += dot(K, a, B + (size_t)j * lb);
+            }
+        }
+    }
+
+    void add_rows(int M, int N, const Scalar* b, Scalar* Y) {
+        for (int i = 0; i < M; ++i) {
+            axpy(N, 1.0, b, Y + (size_t)i * N);
+        }
+    }
+
+    void sum_rows(int M, int N, const Scalar* G, Scalar* g) {
+        for (int i = 0; i < M; ++i) {
+            axpy(N, 1.0, G + (size_t)i * N, g);
+        }
+    }
+
+    void mul_acc(int n, const Scalar* a, const Scalar* b, Scalar* y) {
+        int i = 0;
+#ifdef MG_SIMD
+        for (; i + MG_W <= n; i += MG_W) {
+            vstore(y + i, vfmadd(vload(a + i), vload(b + i), vload(y + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            y[i] += a[i] * b[i];
+        }
+    }
+
+    void relu(int n, const Scalar* x, Scalar* y) {
+        int i = 0;
+#ifdef MG_SIMD
+        for (; i + MG_W <= n; i += MG_W) {
+            vstore(y + i, vmax(vload(x + i), vzero()));
+        }
+#endif
+        for (; i < n; ++i) {
+            y[i] = x[i] < 0 ? 0.0 : x[i];
+        }
+    }
+
+    void relu_backward(int n, const Scalar* y, const Scalar* gy, Scalar* gx) {
+        int i = 0;
+#ifdef MG_SIMD
+        for (; i + MG_W <= n; i += MG_W) {
+            vstore(gx + i, vadd(vload(gx + i), vpositive(vload(y + i), vload(gy + i))));
+        }
+#endif
+        for (; i < n; ++i) {
+            gx[i] += (y[i] > 0 ? 1.0 : 0.0) * gy[i];
+        }
+    }
+
+    void tanh_backward(int n, const Scalar* y, const Scalar* gy, Scalar* gx) {
+        int i = 0;
+#ifdef MG_SIMD
+        vec one = vset1(1.0);
+        for (; i + MG_W <= n; i += MG_W) {
+            vec t = vload(y + i);
+            vec d = vadd(one, vmul(vset1(-1.0), vmul(t, t)));
+            vstore(gx + i, vfmadd(d, vload(gy + i), vload(gx + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            gx[i] += (1.0 - y[i] * y[i]) * gy[i];
+        }
+    }
+
+    void zero(int n, Scalar* y) {
+        std::fill(y, y + n, 0.0);
+    }
+
+    void to_bf16(int n, const Scalar* x, bf16* y) {
+        for (int i = 0; i < n; ++i) {
+            y[i] = bf16((float)x[i]);
+        }
+    }
+
+    void from_bf16(int n, const bf16* x, Scalar* y) {
+        for (int i = 0; i < n; ++i) {
+            y[i] = (float)x[i];
+        }
+    }
+
+#if defined(__AVX2__)
+    static inline int32_t hsum_epi32(__m256i v) {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(s);
+    }
+#endif
+
+    int32_t dot_u8s8(int n, const uint8_t* x, const int8_t* w) {
+        int i = 0;
+        int32_t s = 0;
+#if defined(MG_INT8_AVX512_VNNI)
+        // vpdpbusd: 64 u8 x s8 products summed in groups of 4 into 16 int32s
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 64 <= n; i += 64) {
+            acc = _mm512_dpbusd_epi32(acc, _mm512_loadu_si512(x + i), _mm512_loadu_si512(w + i));
+        }
+        // Zero-masked extracts, as in vsum
+        s = hsum_epi32(_mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xF, acc, 0),
+                                        _mm512_maskz_extracti64x4_epi64(0xF, acc, 1)));
+#elif defined(MG_INT8_AVX_VNNI)
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 32 <= n; i += 32) {
+            acc = _mm256_dpbusd_avx_epi32(acc, _mm256_loadu_si256((const __m256i*)(x + i)),
+                                          _mm256_loadu_si256((const __m256i*)(w + i)));
+        }
+        s = hsum_epi32(acc);
+#elif defined(__AVX2__)
+        // vpmaddubsw: u8 x s8 pairs into int16, then vpmaddwd widens to int32
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 32 <= n; i += 32) {
+            __m256i p = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(x + i)),
+                                             _mm256_loadu_si256((const __m256i*)(w + i)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(p, ones));
+        }
+        s = hsum_epi32(acc);
+#endif
+        for (; i < n; ++i) {
+            s += (int32_t)x[i] * w[i];
+        }
+        return s;
+    }
+
+    void sgd_step(int n, Scalar lr, Scalar momentum, Scalar* p, const Scalar* g, Scalar* vel) {
+        int i = 0;
+        if (momentum == 0.0) {
+            axpy(n, -lr, g, p);
+            return;
+        }
+#ifdef MG_SIMD
+        vec vmu = vset1(momentum), vlr = vset1(-lr);
+        for (; i + MG_W <= n; i += MG_W) {
+            vec u = vfmadd(vmu, vload(vel + i), vload(g + i));
+            vstore(vel + i, u);
+            vstore(p + i, vfmadd(vlr, u, vload(p + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            vel[i] = momentum * vel[i] + g[i];
+            p[i] -= lr * vel[i];
+        }
+    }
+
+    void adam_step(int n, Scalar lr, Scalar beta1, Scalar beta2, Scalar eps, Scalar weight_decay, bool decoupled,
+                   Scalar c1, Scalar c2, Scalar* p, const Scalar* g, Scalar* m, Scalar* v) {
+        const Scalar l2 = decoupled ? 0.0 : weight_decay;      // folded into the gradient
+        const Scalar shrink = decoupled ? 1.0 - lr * weight_decay : 1.0; // applied to the weight
+        int i = 0;
+#ifdef MG_SIMD
+        vec vb1 = vset1(beta1), vb1c = vset1(1.0 - beta1);
+        vec vb2 = vset1(beta2), vb2c = vset1(1.0 - beta2);
+        vec vl2 = vset1(l2), vshrink = vset1(shrink);
+        vec vstep = vset1(-lr * c1), vc2 = vset1(c2), veps = vset1(eps);
+        for (; i + MG_W <= n; i += MG_W) {
+            vec pi = vload(p + i);
+            vec gi = vfmadd(vl2, pi, vload(g + i));
+            vec mi = vfmadd(vb1, vload(m + i), vmul(vb1c, gi));
+            vec vi = vfmadd(vb2, vload(v + i), vmul(vb2c, vmul(gi, gi)));
+            vstore(m + i, mi);
+            vstore(v + i, vi);
+            vec denom = vfmadd(vsqrt(vi), vc2, veps);
+            vstore(p + i, vfmadd(vstep, vdiv(mi, denom), vmul(pi, vshrink)));
+        }
+#endif
+        for (; i < n; ++i) {
+            Scalar gi = g[i] + l2 * p[i];
+            m[i] = beta1 * m[i] + (1.0 - beta1) * gi;
+            v[i] = beta2 * v[i] + (1.0 - beta2) * gi * gi;
+            p[i] = p[i] * shrink - lr * c1 * m[i] / (std::sqrt(v[i]) * c2 + eps);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include "Scalar.h"
+
+// --------------------------------------------------------------------------
+// DENSE KERNELS
+// --------------------------------------------------------------------------
+// Row-major Scalar kernels used by Tensor's forward and backward passes.
+// Compiled for AVX-512 or AVX2 when the compiler targets them
+// (/arch:AVX2, -mavx2 -mfma, -march=native, ...), scalar otherwise.
+//
+// All "accumulate" kernels ADD into their output, the same way every
+// node's _backward() does `grad += ...`.
+
+namespace kernels {
+
+    // Name of the instruction set the kernels were compiled for
+    const char* isa();
+
+    // Same for the int8 kernel below: "AVX-512 VNNI", "AVX-VNNI", "AVX2" or "scalar"
+    const char* isa_int8();
+
+    // y[i] += a * x[i]
+    void axpy(int n, Scalar a, const Scalar* x, Scalar* y);
+
+    // sum_i x[i] * y[i]
+    Scalar dot(int n, const Scalar* x, const Scalar* y);
+
+    // Matrices are row-major. ldb / ldc are the row strides of B / C
+    // (0 = tightly packed), so a GEMM can run on a sub-block in place.
+
+    // C (MxN) += A (MxK) * B (KxN)
+    void gemm_nn(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb = 0, int ldc = 0);
+
+    // C (MxN) += A^T * B, with A stored as KxM
+    void gemm_tn(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb = 0, int ldc = 0);
+
+    // C (MxN) += A * B^T, with B stored as NxK
+    void gemm_nt(int M, int N, int K, const Scalar* A, const Scalar* B, Scalar* C, int ldb = 0);
+
+    // Y (MxN) += b broadcast over every row
+    void add_rows(int M, int N, const Scalar* b, Scalar* Y);
+
+    // g (N) += sum over the rows of G (MxN)
+    void sum_rows(int M, int N, const Scalar* G, Scalar* g);
+
+    // y[i] += a[i] * b[i]
+    void mul_acc(int n, const Scalar* a, const Scalar* b, Scalar* y);
+
+    // y[i] = max(x[i], 0)
+    void relu(int n, const Scalar* x, Scalar* y);
+
+    // gx[i] += (y[i] > 0) * gy[i], where y is the ReLU output
+    void relu_backward(int n, const Scalar* y, const Scalar* gy, Scalar* gx);
+
+    // gx[i] += (1 - y[i]^2) * gy[i], where y is the tanh output
+    void tanh_backward(int n, const Scalar* y, const Scalar* gy, Scalar* gx);
+
+    // y[i] = 0
+    void zero(int n, Scalar* y);
+
+    // y[i] = bf16(x[i]) (round to nearest even) and back
+    void to_bf16(int n, const Scalar* x, bf16* y);
+    void from_bf16(int n, const bf16* x, Scalar* y);
+
+    // sum_i x[i] * w[i] in int32, x unsigned, w signed (QuantizedMLP).
+    // x[i] must be <= 127: AVX2's vpmaddubsw adds pairs of products in 16
+    // bits with saturation, and 2 * 127 * 128 still fits.
+    int32_t dot_u8s8(int n, const uint8_t* x, const int8_t* w);
+
+    // Fused SGD update, one pass over the parameters:
+    //     vel = momentum * vel + g;  p -= lr * vel
+    // (vel is not touched when momentum == 0)
+    void sgd_step(int n, Scalar lr, Scalar momentum, Scalar* p, const Scalar* g, Scalar* vel);
+
+    // Fused Adam/AdamW update, one pass over the parameters:
+    //     g' = g + weight_decay * p               (Adam, L2 penalty)
+    //     p -= lr * weight_decay * p              (AdamW, decoupled)
+    //     m = beta1 * m + (1 - beta1) * g'
+    //     v = beta2 * v + (1 - beta2) * g'^2
+    //     p -= lr * c1 * m / (sqrt(v) * c2 + eps)
+    // c1 = 1 / (1 - beta1^t) and c2 = 1 / sqrt(1 - beta2^t) are the bias corrections.
+    void adam_step(int n, Scalar lr, Scalar beta1, Scalar beta2, Scalar eps, Scalar weight_decay, bool decoupled,
+                   Scalar c1, Scalar c2, Scalar* p, const Scalar* g, Scalar* m, Scalar* v);
+}
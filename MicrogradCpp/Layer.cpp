@@ -1,9 +1,19 @@
 #include "Layer.h"
+#include "Kernels.h"
 // 1. Constructor
-Layer::Layer(int nin, int nout, bool nonlin) {
+Layer::Layer(int nin, int nout, bool nonlin)
+    : Layer(nin, nout, nonlin, std::make_shared<ParameterStore>((size_t)nout * (nin + 1)), 0)
+{
+}
+
+Layer::Layer(int nin, int nout, bool nonlin, std::shared_ptr<ParameterStore> store, size_t offset) {
+    _store = std::move(store);
+    _offset = offset;
+    _count = (size_t)nout * (nin + 1);
+
     for (int i = 0; i < nout; ++i) {
         // Create 'nout' neurons, each expecting 'nin' inputs
-        neurons.push_back(std::make_shared<Neuron>(nin, nonlin));
+        neurons.push_back(std::make_shared<Neuron>(nin, nonlin, _store, offset + (size_t)i * (nin + 1)));
     }
 }
 
@@ -19,6 +29,56 @@ std::vector<std::shared_ptr<Value>> Layer::operator()(const std::vector<std::sha
     return out;
 }
 
+// 2b. Forward Pass on a Tape
+std::vector<Var> Layer::operator()(Tape& tape, const std::vector<Var>& x) {
+    std::vector<Var> out;
+    out.reserve(neurons.size());
+
+    for (auto& neuron : neurons) {
+        out.push_back((*neuron)(tape, x));
+    }
+
+    return out;
+}
+
+// 2c. Forward Pass on Tensors
+std::shared_ptr<Tensor> Layer::operator()(const std::shared_ptr<Tensor>& x, Scalar* grad_sink,
+                                          const Scalar* param_source) {
+    Scalar* grads = grad_sink ? grad_sink : _store->grad.data() + _offset;
+    const Scalar* params = param_source ? param_source : _store->data.data() + _offset;
+    auto out = x->linear(params, grads, (int)neurons.size());
+    return neurons[0]->nonlin ? out->relu() : out;
+}
+
+// 2d. Inference (no graph)
+void Layer::predict(const Scalar* x, Scalar* out) const {
+    for (size_t j = 0; j < neurons.size(); ++j) {
+        out[j] = neurons[j]->predict(x);
+    }
+}
+
+void Layer::predict(const Scalar* X, int rows, Scalar* out) const {
+    const int nin = (int)neurons[0]->w.size(), nout = (int)neurons.size(), ld = nin + 1;
+    const Scalar* params = _store->data.data() + _offset;
+    for (int r = 0; r < rows; ++r) {
+        for (int j = 0; j < nout; ++j) {
+            out[(size_t)r * nout + j] = params[(size_t)j * ld + nin];
+        }
+    }
+    kernels::gemm_nt(rows, nout, nin, X, params, out, ld);
+    if (neurons[0]->nonlin) {
+        kernels::relu(rows * nout, out, out);
+    }
+}
+
+void Layer::predict(const Scalar* params, int nin, int nout, bool nonlin, const Scalar* x, Scalar* out) {
+    for (int j = 0; j < nout; ++j) {
+        const Scalar* p = params + (size_t)j * (nin + 1);
+        Scalar act = p[nin] + kernels::dot(nin, p, x);
+        out[j] = (nonlin && act < 0) ? 0.0 : act;
+    }
+}
+
 // 3. Parameters
 std::vector<std::shared_ptr<Value>> Layer::parameters() {
     std::vector<std::shared_ptr<Value>> params;
@@ -1,6 +1,7 @@
 #pragma once
 #include "Neuron.h"
 #include "Module.h"
+#include "Tensor.h"
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -9,8 +10,36 @@ class Layer : public Module {
   public:
     std::vector<std::shared_ptr<Neuron>> neurons;
 
+    // Allocates its own storage for nout * (nin + 1) parameters
     Layer(int nin, int nout, bool nonlin = true);
+
+    // Layer inside a larger model: parameters are store[offset, offset + nout * (nin + 1)),
+    // neuron after neuron, each as [w..., b]
+    Layer(int nin, int nout, bool nonlin, std::shared_ptr<ParameterStore> store, size_t offset);
     std::vector<std::shared_ptr<Value>> operator()(const std::vector<std::shared_ptr<Value>>& x);
+    std::vector<Var> operator()(Tape& tape, const std::vector<Var>& x);
+
+    // Tensor-backed forward pass: x is (rows x nin), result is (rows x nout).
+    // One linear and one activation node for the whole layer, reading the
+    // weights in place from the parameter storage.
+    // grad_sink: optional buffer laid out like parameters(); when given,
+    // backward() accumulates this layer's gradients there instead of into
+    // the shared storage (so several threads can share one Layer).
+    // param_source: optional buffer laid out like parameters() to read the
+    // weights from instead of the storage (e.g. a per-thread snapshot).
+    std::shared_ptr<Tensor> operator()(const std::shared_ptr<Tensor>& x, Scalar* grad_sink = nullptr,
+                                       const Scalar* param_source = nullptr);
+
+    // Inference only: out[j] = neurons[j]->predict(x), builds no graph
+    void predict(const Scalar* x, Scalar* out) const;
+
+    // Batched inference: X is (rows x nin), out is (rows x nout), one GEMM
+    // on the parameter storage, builds no graph
+    void predict(const Scalar* X, int rows, Scalar* out) const;
+
+    // The same math on a raw parameter block laid out like a Layer's
+    // storage (nout rows of [w..., b]), e.g. a memory-mapped checkpoint
+    static void predict(const Scalar* params, int nin, int nout, bool nonlin, const Scalar* x, Scalar* out);
     std::vector<std::shared_ptr<Value>> parameters() override;
 
     friend std::ostream& operator<<(std::ostream& os, const Layer& l);
@@ -1,10 +1,22 @@
 #include "MLP.h"
+#include "Checkpoint.h"
+#include "Profile.h"
+#include <algorithm>
 
 // 1. Constructor
 MLP::MLP(int nin, std::vector<int> nouts) {
+    // One contiguous block for every parameter of every layer
+    size_t total = 0;
+    for (size_t i = 0; i < nouts.size(); ++i) {
+        total += (size_t)nouts[i] * ((i == 0 ? nin : nouts[i - 1]) + 1);
+    }
+    _store = std::make_shared<ParameterStore>(total);
+    _count = total;
+
     // The size of the inputs for the *current* layer being built.
     // Initially, this is the number of inputs to the whole network.
     int current_nin = nin;
+    size_t offset = 0;
 
     for (size_t i = 0; i < nouts.size(); ++i) {
         int current_nout = nouts[i];
@@ -15,7 +27,8 @@ MLP::MLP(int nin, std::vector<int> nouts) {
         bool nonlin = !is_last_layer;
 
         // Create the layer
-        layers.push_back(std::make_shared<Layer>(current_nin, current_nout, nonlin));
+        layers.push_back(std::make_shared<Layer>(current_nin, current_nout, nonlin, _store, offset));
+        offset += layers.back()->num_parameters();
 
         // The output of this layer becomes the input of the next
         current_nin = current_nout;
@@ -24,6 +37,7 @@ MLP::MLP(int nin, std::vector<int> nouts) {
 
 // 2. Forward Pass
 std::vector<std::shared_ptr<Value>> MLP::operator()(std::vector<std::shared_ptr<Value>> x) {
+    MG_PROFILE_SCOPE("MLP.forward.value");
     // We create a temporary variable to hold the data as it flows through the network
     std::vector<std::shared_ptr<Value>> current_x = x;
 
@@ -36,6 +50,95 @@ std::vector<std::shared_ptr<Value>> MLP::operator()(std::vector<std::shared_ptr<
     return current_x;
 }
 
+// 2b. Forward Pass on a Tape
+std::vector<Var> MLP::operator()(Tape& tape, std::vector<Var> x) {
+    MG_PROFILE_SCOPE("MLP.forward.tape");
+    for (auto& layer : layers) {
+        x = (*layer)(tape, x);
+    }
+
+    return x;
+}
+
+// 2c. Forward Pass on Tensors
+// Runs layers [first, last) on x
+static std::shared_ptr<Tensor> run_layers(const std::vector<std::shared_ptr<Layer>>& layers, size_t first, size_t last,
+                                          std::shared_ptr<Tensor> x, Scalar* grad_sink, const Scalar* param_source) {
+    for (size_t l = first; l < last; ++l) {
+        x = (*layers[l])(x, grad_sink, param_source);
+        // Each layer's parameters follow the previous layer's in parameters() order
+        if (grad_sink) grad_sink += layers[l]->num_parameters();
+        if (param_source) param_source += layers[l]->num_parameters();
+    }
+    return x;
+}
+
+std::shared_ptr<Tensor> MLP::operator()(std::shared_ptr<Tensor> x, Scalar* grad_sink, const Scalar* param_source) {
+    MG_PROFILE_SCOPE("MLP.forward.tensor");
+    if (checkpoint_every <= 0 || layers.empty()) {
+        return run_layers(layers, 0, layers.size(), x, grad_sink, param_source);
+    }
+
+    // Every group of k layers but the last becomes one segment of a single
+    // checkpoint node. The last group is the first one backward() visits,
+    // so recomputing it would not lower the peak: it keeps its graph.
+    const size_t k = (size_t)checkpoint_every;
+    const size_t tail = (layers.size() - 1) / k * k;
+    std::vector<Tensor::Segment> segments;
+    for (size_t first = 0; first < tail; first += k) {
+        auto group = std::vector<std::shared_ptr<Layer>>(layers.begin() + first, layers.begin() + first + k);
+        segments.push_back([group, grad_sink, param_source](const std::shared_ptr<Tensor>& in) {
+            return run_layers(group, 0, group.size(), in, grad_sink, param_source);
+        });
+        for (auto& layer : group) {
+            if (grad_sink) grad_sink += layer->num_parameters();
+            if (param_source) param_source += layer->num_parameters();
+        }
+    }
+    if (!segments.empty()) {
+        x = x->checkpoint(std::move(segments), checkpoint_bf16);
+    }
+
+    return run_layers(layers, tail, layers.size(), x, grad_sink, param_source);
+}
+
+// 2d. Inference (no graph)
+void MLP::predict(const Scalar* x, Scalar* out) const {
+    // Ping-pong buffers for the hidden activations, reused across calls
+    static thread_local std::vector<Scalar> buf[2];
+
+    const Scalar* in = x;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = *layers[l];
+        Scalar* dst = out;
+        if (l + 1 < layers.size()) {
+            std::vector<Scalar>& b = buf[l % 2];
+            if (b.size() < layer.neurons.size()) b.resize(layer.neurons.size());
+            dst = b.data();
+        }
+        layer.predict(in, dst);
+        in = dst;
+    }
+}
+
+void MLP::predict(const Scalar* X, int rows, Scalar* out) const {
+    static thread_local std::vector<Scalar> buf[2];
+
+    const Scalar* in = X;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = *layers[l];
+        Scalar* dst = out;
+        if (l + 1 < layers.size()) {
+            std::vector<Scalar>& b = buf[l % 2];
+            const size_t n = (size_t)rows * layer.neurons.size();
+            if (b.size() < n) b.resize(n);
+            dst = b.data();
+        }
+        layer.predict(in, rows, dst);
+        in = dst;
+    }
+}
+
 // 3. Parameters
 std::vector<std::shared_ptr<Value>> MLP::parameters() {
     std::vector<std::shared_ptr<Value>> params;
@@ -49,7 +152,38 @@ std::vector<std::shared_ptr<Value>> MLP::parameters() {
     return params;
 }
 
-// 4. Print
+// 4. Checkpoints
+void MLP::save(const std::string& path) const {
+    std::vector<CheckpointLayer> arch;
+    for (auto& layer : layers) {
+        arch.push_back({ (uint32_t)layer->neurons.size(), layer->neurons[0]->nonlin ? 1u : 0u });
+    }
+    int nin = (int)layers[0]->neurons[0]->w.size();
+    ParameterSpan span = parameter_span();
+    save_checkpoint(path, nin, arch, span.data, span.size);
+}
+
+MLP MLP::load(const std::string& path) {
+    MappedModel file(path);
+
+    std::vector<int> nouts;
+    for (const CheckpointLayer& l : file.layers()) {
+        nouts.push_back((int)l.nout);
+    }
+    MLP model(file.nin(), nouts);
+
+    // The file's flags win over the constructor's defaults
+    for (size_t i = 0; i < model.layers.size(); ++i) {
+        for (auto& neuron : model.layers[i]->neurons) {
+            neuron->nonlin = file.layers()[i].nonlin != 0;
+        }
+    }
+
+    std::copy(file.parameters(), file.parameters() + file.num_parameters(), model.parameter_span().data);
+    return model;
+}
+
+// 5. Print
 std::ostream& operator<<(std::ostream& os, const MLP& m) {
     os << "MLP of [";
     for (size_t i = 0; i < m.layers.size(); ++i) {
@@ -2,24 +2,71 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <string>
 #include "Module.h"
 #include "Layer.h"
 
 struct MLP : public Module {
     std::vector<std::shared_ptr<Layer>> layers;
 
+    // Gradient checkpointing for the Tensor forward pass: 0 keeps every
+    // activation until backward() (the default); k > 0 groups the layers
+    // into segments of k and keeps only each segment's output, recomputing
+    // the segment's forward during backward() (see Tensor::checkpoint).
+    // 1 = per Layer. Trades roughly one extra forward pass for peak memory.
+    int checkpoint_every = 0;
+
+    // Mixed precision for checkpointing: keep the saved segment inputs as
+    // bf16 instead of Scalar (a quarter of the memory of a double); the
+    // parameters and all arithmetic stay in Scalar.
+    bool checkpoint_bf16 = false;
+
     // Constructor
     // nin   = number of inputs to the network
     // nouts = vector defining the size of each layer 
     //         e.g., {4, 4, 1} means two hidden layers of 4, and one output of 1
+    // All weights and biases live in one ParameterStore, in parameters() order.
     MLP(int nin, std::vector<int> nouts);
 
     // Forward Pass
     std::vector<std::shared_ptr<Value>> operator()(std::vector<std::shared_ptr<Value>> x);
 
+    // Forward Pass recorded on a Tape
+    // Parameters are copied onto the tape as leaves; tape.backward() writes
+    // their gradients back into the Values returned by parameters().
+    std::vector<Var> operator()(Tape& tape, std::vector<Var> x);
+
+    // Forward Pass on Tensors: x is a batch (N x nin), result is (N x nout)
+    // Builds a handful of graph nodes per layer instead of one per scalar,
+    // whatever the batch size. A single backward() from a loss over the
+    // whole batch accumulates every parameter's gradient across all N rows.
+    // grad_sink: optional buffer of parameters().size() Scalars that receives
+    // the gradients instead of the Values (see DataParallelTrainer).
+    // param_source: optional buffer laid out the same way that the weights
+    // are read from instead of the Values (see HogwildTrainer).
+    std::shared_ptr<Tensor> operator()(std::shared_ptr<Tensor> x, Scalar* grad_sink = nullptr,
+                                       const Scalar* param_source = nullptr);
+
+    // Inference only: writes the nout outputs for one input of nin values.
+    // Runs the same Neuron/Layer math on the parameters' data without
+    // creating any graph node, closure or shared_ptr, and performs no heap
+    // allocation once the calling thread has run it once.
+    void predict(const Scalar* x, Scalar* out) const;
+
+    // Batched inference: X is (rows x nin) row-major, out is (rows x nout).
+    // The Tensor forward's GEMMs without its graph, gradient buffers or
+    // closures (see InferenceServer).
+    void predict(const Scalar* X, int rows, Scalar* out) const;
+
     // Get parameters from all layers
     std::vector<std::shared_ptr<Value>> parameters() override;
 
+    // Checkpoints (see Checkpoint.h): architecture, nonlin flags and the
+    // flat parameter storage. For inference only, MappedModel serves the
+    // same file without loading it.
+    void save(const std::string& path) const;
+    static MLP load(const std::string& path);
+
     // Print
     friend std::ostream& operator<<(std::ostream& os, const MLP& m);
 };
\ No newline at end of file
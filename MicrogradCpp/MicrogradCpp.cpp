@@ -7,7 +7,7 @@
 int main()
 {
  
-    auto t = new Test();
+    Test test;
 }
 
 // Run program: Ctrl + F5 or Debug > Start Without Debugging menu
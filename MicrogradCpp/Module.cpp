@@ -1,7 +1,14 @@
 #include "Module.h"
+#include <algorithm>
 
 // 1. Zero Grad Implementation
 void Module::zero_grad() {
+    if (_store) {
+        Scalar* g = _store->grad.data() + _offset;
+        std::fill(g, g + _count, 0.0);
+        return;
+    }
+
     // Calls the VIRTUAL parameters() method
     // This will hit the child's implementation (e.g., Layer::parameters)
     for (auto& p : parameters()) {
@@ -12,4 +19,10 @@ void Module::zero_grad() {
 // 2. Parameters Implementation (Base Case)
 std::vector<std::shared_ptr<Value>> Module::parameters() {
     return {}; // Returns empty vector
+}
+
+// 3. Parameter Span
+ParameterSpan Module::parameter_span() const {
+    if (!_store) return ParameterSpan{ nullptr, nullptr, 0 };
+    return ParameterSpan{ _store->data.data() + _offset, _store->grad.data() + _offset, _count };
 }
\ No newline at end of file
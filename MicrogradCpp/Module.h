@@ -3,6 +3,23 @@
 #include <memory>
 #include "Value.h" // Assuming Value struct is defined here
 
+// Contiguous backing store for a model's parameters.
+// Parameter i's data and grad are data[i] and grad[i]; the parameter
+// Values are views into these two buffers, in parameters() order.
+struct ParameterStore {
+    std::vector<Scalar> data;
+    std::vector<Scalar> grad;
+
+    explicit ParameterStore(size_t n) : data(n, 0.0), grad(n, 0.0) {}
+};
+
+// Raw view of a module's parameters: data[i] / grad[i] belong to parameters()[i]
+struct ParameterSpan {
+    Scalar* data;
+    Scalar* grad;
+    size_t size;
+};
+
 struct Module {
     // 1. Virtual Destructor
     // Essential in C++ to ensure derived classes are cleaned up correctly
@@ -10,10 +27,25 @@ struct Module {
 
     // 2. zero_grad
     // Resets gradients of all parameters to 0.0
+    // (a single memset when the parameters are contiguous)
     void zero_grad();
 
     // 3. parameters
     // Returns the list of trainable parameters (weights + biases)
     // defined as 'virtual' so derived classes (Neuron, Layer) can override it.
     virtual std::vector<std::shared_ptr<Value>> parameters();
+
+    // 4. parameter_span
+    // Zero-copy access to the same parameters as two flat arrays.
+    // size is 0 if this module has no contiguous storage.
+    ParameterSpan parameter_span() const;
+
+    // Number of parameters in that span
+    size_t num_parameters() const { return _count; }
+
+  protected:
+    // This module's parameters are store->data[offset, offset + count)
+    std::shared_ptr<ParameterStore> _store;
+    size_t _offset = 0;
+    size_t _count = 0;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Neuron.h"
+#include "Kernels.h"
 #include <random>
 #include <iostream>
 
@@ -12,35 +13,60 @@ double random_uniform() {
 }
 
 // 1. Constructor
-Neuron::Neuron(int nin, bool nonlin) : nonlin(nonlin) {
+Neuron::Neuron(int nin, bool nonlin)
+    : Neuron(nin, nonlin, std::make_shared<ParameterStore>(nin + 1), 0)
+{
+}
+
+Neuron::Neuron(int nin, bool nonlin, std::shared_ptr<ParameterStore> store, size_t offset) : nonlin(nonlin) {
+    _store = std::move(store);
+    _offset = offset;
+    _count = nin + 1;
+
+    Scalar* data = _store->data.data() + offset;
+    Scalar* grad = _store->grad.data() + offset;
+
     // Initialize weights with random values between -1 and 1
     for (int i = 0; i < nin; ++i) {
-        w.push_back(std::make_shared<Value>(random_uniform()));
+        data[i] = random_uniform();
+        w.push_back(std::make_shared<Value>(data + i, grad + i, _store));
     }
     // Initialize bias with random value between -1 and 1
-    b = std::make_shared<Value>(random_uniform());
+    data[nin] = random_uniform();
+    b = std::make_shared<Value>(data + nin, grad + nin, _store);
 }
 
 // 2. Forward Pass (operator())
 std::shared_ptr<Value> Neuron::operator()(const std::vector<std::shared_ptr<Value>>& x) {
-    // act = sum(w * x) + b
-
-    // Start with the bias
-    std::shared_ptr<Value> act = b;
-
-    // Accumulate the dot product
-    for (size_t i = 0; i < w.size(); ++i) {
-        // We assume x.size() matches w.size()
-        // act = act + (w[i] * x[i])
-        act = act + (w[i] * x[i]);
-    }
+    // act = sum(w * x) + b, then the non-linearity, as one fused graph node
+    // (see Value::dot_bias_act). We assume x.size() matches w.size().
 
     // Apply non-linearity if requested
     // Andrej's code typically uses ReLU in the modern version, 
     // but Tanh in the original video. Since you have 'bool nonlin',
     // we use ReLU (standard modern default). 
-    // Change to .tanh() if you want the exact video demo.
-    return nonlin ? act->relu() : act;
+    // Change to Act::Tanh if you want the exact video demo.
+    return Value::dot_bias_act(w, x, b, nonlin ? Act::ReLU : Act::None);
+}
+
+// 2b. Forward Pass on a Tape
+Var Neuron::operator()(Tape& tape, const std::vector<Var>& x) {
+    Var act = tape.param(b);
+
+    for (size_t i = 0; i < w.size(); ++i) {
+        act = act + (tape.param(w[i]) * x[i]);
+    }
+
+    return nonlin ? act.relu() : act;
+}
+
+// 2c. Inference (no graph)
+Scalar Neuron::predict(const Scalar* x) const {
+    // Straight from the flat storage: [w..., b]
+    const Scalar* p = _store->data.data() + _offset;
+    const int nin = (int)w.size();
+    Scalar act = p[nin] + kernels::dot(nin, p, x);
+    return (nonlin && act < 0) ? 0.0 : act;
 }
 
 // 3. Parameters
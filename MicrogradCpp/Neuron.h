@@ -3,6 +3,10 @@
 #include <memory>
 #include "Value.h"
 #include "Module.h"
+#include "Tape.h"
+
+// Uniform in [-1, 1): the initial value of every weight and bias
+double random_uniform();
 
 struct Neuron : public Module {
     std::vector<std::shared_ptr<Value>> w; // Weights
@@ -10,11 +14,22 @@ struct Neuron : public Module {
     bool nonlin;                           // Apply non-linearity?
 
     // Constructor: nin = number of inputs
+    // Allocates its own storage for the nin + 1 parameters.
     Neuron(int nin, bool nonlin = true);
 
+    // Constructor for a neuron inside a larger model: its parameters are
+    // store[offset, offset + nin + 1), laid out as [w..., b].
+    Neuron(int nin, bool nonlin, std::shared_ptr<ParameterStore> store, size_t offset);
+
     // Forward pass (calls the neuron)
     std::shared_ptr<Value> operator()(const std::vector<std::shared_ptr<Value>>& x);
 
+    // Forward pass recorded on a Tape (same math, no per-node heap allocations)
+    Var operator()(Tape& tape, const std::vector<Var>& x);
+
+    // Inference only: same math on plain Scalars, builds no graph
+    Scalar predict(const Scalar* x) const;
+
     // Override from Module
     std::vector<std::shared_ptr<Value>> parameters() override;
 
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// Operation tag for a graph node: one byte per node, and a switch on it
+// replaces a closure per node. op_name() gives the symbol for printing.
+enum class Op : uint8_t {
+    Leaf, // no children (inputs, parameters, constants)
+    Add,
+    Mul,
+    Pow,
+    ReLU,
+    Tanh,
+    Exp,
+    DotBiasAct // act(b + sum_i w[i] * x[i]) in one node (see Value::dot_bias_act)
+};
+
+// Activation applied by a fused node
+enum class Act : uint8_t {
+    None,
+    ReLU,
+    Tanh
+};
+
+// Printable name, matching the tags used by Value
+inline const char* op_name(Op op) {
+    switch (op) {
+    case Op::Leaf: return "";
+    case Op::Add:  return "+";
+    case Op::Mul:  return "*";
+    case Op::Pow:  return "**";
+    case Op::ReLU: return "ReLU";
+    case Op::Tanh: return "tanh";
+    case Op::Exp:  return "exp";
+    case Op::DotBiasAct: return "dot";
+    }
+    return "?";
+}
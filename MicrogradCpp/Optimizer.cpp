@@ -0,0 +1,86 @@
+#include "Optimizer.h"
+#include "Kernels.h"
+#include "Profile.h"
+#include <cmath>
+
+// --------------------------------------------------------------------------
+// OPTIMIZER (BASE)
+// --------------------------------------------------------------------------
+
+Optimizer::Optimizer(Module& module, double lr) : lr(lr), span(module.parameter_span()) {
+    if (span.size == 0) {
+        for (auto& p : module.parameters()) {
+            params.push_back(p.get());
+        }
+        data.resize(params.size());
+        grad.resize(params.size());
+        span = ParameterSpan{ data.data(), grad.data(), params.size() };
+    }
+}
+
+void Optimizer::zero_grad() {
+    if (params.empty()) {
+        kernels::zero((int)span.size, span.grad);
+        return;
+    }
+    for (Value* p : params) {
+        p->grad = 0.0;
+    }
+}
+
+void Optimizer::gather() {
+    for (size_t i = 0; i < params.size(); ++i) {
+        data[i] = params[i]->data;
+        grad[i] = params[i]->grad;
+    }
+}
+
+void Optimizer::scatter() {
+    for (size_t i = 0; i < params.size(); ++i) {
+        params[i]->data = data[i];
+    }
+}
+
+// --------------------------------------------------------------------------
+// SGD
+// --------------------------------------------------------------------------
+
+SGD::SGD(Module& module, double lr, double momentum)
+    : Optimizer(module, lr), momentum(momentum), velocity(span.size, 0.0)
+{
+}
+
+void SGD::step() {
+    MG_PROFILE_SCOPE("SGD.step");
+    gather();
+    kernels::sgd_step((int)span.size, lr, momentum, span.data, span.grad, velocity.data());
+    scatter();
+}
+
+// --------------------------------------------------------------------------
+// ADAM / ADAMW
+// --------------------------------------------------------------------------
+
+Adam::Adam(Module& module, double lr, double beta1, double beta2, double eps, double weight_decay)
+    : Optimizer(module, lr), beta1(beta1), beta2(beta2), eps(eps), weight_decay(weight_decay),
+      m(span.size, 0.0), v(span.size, 0.0)
+{
+}
+
+void Adam::step() {
+    MG_PROFILE_SCOPE("Adam.step");
+    ++t;
+    double c1 = 1.0 / (1.0 - std::pow(beta1, (double)t));
+    double c2 = 1.0 / std::sqrt(1.0 - std::pow(beta2, (double)t));
+
+    gather();
+    kernels::adam_step((int)span.size, lr, beta1, beta2, eps, weight_decay, decoupled,
+                       c1, c2, span.data, span.grad, m.data(), v.data());
+    scatter();
+}
+
+AdamW::AdamW(Module& module, double lr, double beta1, double beta2, double eps, double weight_decay)
+    : Adam(module, lr, beta1, beta2, eps, weight_decay)
+{
+    decoupled = true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Module.h"
+
+// --------------------------------------------------------------------------
+// OPTIMIZERS
+// --------------------------------------------------------------------------
+// An Optimizer is built once per Module and owns all of its state
+// (momentum, first/second moments) in contiguous arrays, one slot per
+// parameter in parameters() order.
+//
+// step() runs one fused SIMD pass (Kernels.h) directly over the module's
+// ParameterStore. Modules without contiguous storage fall back to
+// contiguous working copies that are gathered and scattered each step.
+//
+//     Adam optimizer(model, 0.01);
+//     for (...) {
+//         optimizer.zero_grad();
+//         loss->backward();
+//         optimizer.step();
+//     }
+
+struct Optimizer {
+    double lr; // learning rate
+
+    Optimizer(Module& module, double lr);
+    virtual ~Optimizer() = default;
+
+    // Apply one update from the current gradients
+    virtual void step() = 0;
+
+    // Reset the gradients of every parameter to 0.0
+    void zero_grad();
+
+  protected:
+    ParameterSpan span; // what step() updates: the module's storage, or data/grad below
+
+    // Fallback for modules without contiguous storage
+    std::vector<Value*> params; // collected once, in parameters() order
+    std::vector<Scalar> data;   // working copy of params[i]->data
+    std::vector<Scalar> grad;   // working copy of params[i]->grad
+
+    void gather();  // params -> data, grad (no-op when working in place)
+    void scatter(); // data -> params (no-op when working in place)
+};
+
+// Stochastic Gradient Descent with optional (heavy-ball) momentum
+struct SGD : public Optimizer {
+    double momentum;
+
+    SGD(Module& module, double lr, double momentum = 0.0);
+    void step() override;
+
+  private:
+    std::vector<Scalar> velocity;
+};
+
+// Adam. weight_decay is an L2 penalty added to the gradient.
+struct Adam : public Optimizer {
+    double beta1;
+    double beta2;
+    double eps;
+    double weight_decay;
+
+    Adam(Module& module, double lr = 1e-3, double beta1 = 0.9, double beta2 = 0.999,
+         double eps = 1e-8, double weight_decay = 0.0);
+    void step() override;
+
+  protected:
+    bool decoupled = false; // AdamW
+    long long t = 0;        // steps taken, for bias correction
+    std::vector<Scalar> m;  // first moment
+    std::vector<Scalar> v;  // second moment
+};
+
+// AdamW: Adam with weight decay applied directly to the weights
+// instead of through the gradient.
+struct AdamW : public Adam {
+    AdamW(Module& module, double lr = 1e-3, double beta1 = 0.9, double beta2 = 0.999,
+          double eps = 1e-8, double weight_decay = 1e-2);
+};
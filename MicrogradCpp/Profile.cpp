@@ -0,0 +1,157 @@
+#include "Profile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    const int OP_COUNT = (int)Op::DotBiasAct + 1;
+    const size_t MAX_EVENTS = (size_t)1 << 20; // later scopes are counted as dropped
+
+    struct Event {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+        uint32_t tid;
+        int64_t live_bytes; // at the end of the scope
+    };
+
+    std::atomic<uint64_t> nodes[OP_COUNT];
+    std::atomic<int64_t> live_bytes{ 0 };
+    std::atomic<int64_t> peak_bytes{ 0 };
+
+    std::mutex mutex;
+    std::vector<Event> events;
+    uint64_t dropped = 0;
+
+    const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::atomic<uint32_t> next_tid{ 0 };
+
+    uint32_t thread_id() {
+        static thread_local const uint32_t id = next_tid++;
+        return id;
+    }
+
+    const char* node_name(int op) {
+        return op == (int)Op::Leaf ? "leaf" : op_name((Op)op);
+    }
+}
+
+namespace profiler {
+
+    // 1. Hooks
+    int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    void node_created(Op op, size_t bytes) {
+        nodes[(int)op].fetch_add(1, std::memory_order_relaxed);
+        const int64_t live = live_bytes.fetch_add((int64_t)bytes, std::memory_order_relaxed) + (int64_t)bytes;
+        int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void node_destroyed(size_t bytes) {
+        live_bytes.fetch_sub((int64_t)bytes, std::memory_order_relaxed);
+    }
+
+    void record(const char* name, int64_t begin_ns, int64_t end_ns) {
+        const Event e{ name, begin_ns, end_ns, thread_id(), live_bytes.load(std::memory_order_relaxed) };
+        std::lock_guard<std::mutex> lock(mutex);
+        if (events.size() < MAX_EVENTS) events.push_back(e);
+        else ++dropped;
+    }
+
+    void reset() {
+        for (auto& n : nodes) n = 0;
+        peak_bytes = live_bytes.load();
+        std::lock_guard<std::mutex> lock(mutex);
+        events.clear();
+        dropped = 0;
+    }
+
+    // 2. Text summary
+    void print_summary(std::ostream& os) {
+        if (!enabled()) {
+            os << "Profiler off: build with MICROGRAD_PROFILE defined (CMake -DMICROGRAD_PROFILE=ON)\n";
+            return;
+        }
+
+        struct Total {
+            std::string name;
+            uint64_t calls = 0;
+            int64_t total = 0;
+            int64_t max = 0;
+        };
+        std::vector<Total> totals;
+        uint64_t lost;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const Event& e : events) {
+                auto it = std::find_if(totals.begin(), totals.end(), [&](const Total& t) { return t.name == e.name; });
+                if (it == totals.end()) {
+                    totals.push_back(Total{ e.name });
+                    it = totals.end() - 1;
+                }
+                ++it->calls;
+                it->total += e.end - e.begin;
+                it->max = std::max(it->max, e.end - e.begin);
+            }
+            lost = dropped;
+        }
+        std::sort(totals.begin(), totals.end(), [](const Total& a, const Total& b) { return a.total > b.total; });
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision(3);
+
+        os << std::left << std::setw(28) << "scope" << std::right << std::setw(10) << "calls"
+           << std::setw(14) << "total ms" << std::setw(14) << "mean us" << std::setw(14) << "max us" << "\n";
+        for (const Total& t : totals) {
+            os << std::left << std::setw(28) << t.name << std::right << std::setw(10) << t.calls
+               << std::setw(14) << t.total / 1e6 << std::setw(14) << t.total / 1e3 / t.calls
+               << std::setw(14) << t.max / 1e3 << "\n";
+        }
+        if (lost) os << "(" << lost << " scopes not recorded: over " << MAX_EVENTS << ")\n";
+
+        os << "\nValue nodes created\n";
+        for (int op = 0; op < OP_COUNT; ++op) {
+            const uint64_t n = nodes[op].load();
+            if (n) os << "  " << std::left << std::setw(8) << node_name(op) << std::right << std::setw(12) << n << "\n";
+        }
+        os << "Live Value bytes: " << live_bytes.load() << " (peak " << peak_bytes.load() << ")\n";
+
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    // 3. Chrome trace
+    bool write_chrome_trace(const std::string& path) {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) return false;
+
+        std::fprintf(f, "{\"traceEvents\":[\n");
+        bool first = true;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Event& e : events) {
+            // Names are literals from the code: no characters to escape
+            std::fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"micrograd\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+                         first ? "" : ",\n", e.name, e.tid, e.begin / 1e3, (e.end - e.begin) / 1e3);
+            std::fprintf(f, "{\"name\":\"live Value bytes\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"bytes\":%lld}}",
+                         e.end / 1e3, (long long)e.live_bytes);
+            first = false;
+        }
+        std::fprintf(f, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"peak_value_bytes\":%lld",
+                     (long long)peak_bytes.load());
+        for (int op = 0; op < OP_COUNT; ++op) {
+            std::fprintf(f, ",\"nodes %s\":%llu", node_name(op), (unsigned long long)nodes[op].load());
+        }
+        std::fprintf(f, "}}\n");
+        return std::fclose(f) == 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "Op.h"
+
+// --------------------------------------------------------------------------
+// PROFILER
+// --------------------------------------------------------------------------
+// Opt-in instrumentation of the autograd engine, compiled in only when
+// MICROGRAD_PROFILE is defined (CMake: -DMICROGRAD_PROFILE=ON). Without it
+// the hooks below expand to nothing, so a production build pays nothing.
+//
+// Records
+//   - Value nodes created, per op ("+", "*", "**", "ReLU", "tanh", ...)
+//   - live Value bytes (node plus its child list) and their peak
+//   - timed scopes: MLP forward passes (graph construction), backward()
+//     topological sort and gradient propagation (Value and Tensor),
+//     optimizer steps, plus any MG_PROFILE_SCOPE in user code
+//
+//     {
+//         MG_PROFILE_SCOPE("train step");
+//         ...
+//     }
+//     profiler::print_summary(std::cout);
+//     profiler::write_chrome_trace("trace.json"); // chrome://tracing, Perfetto
+//
+// The report functions exist in every build; without MICROGRAD_PROFILE
+// they have nothing to report.
+
+namespace profiler {
+
+    // True when the hooks are compiled in
+    constexpr bool enabled() {
+#ifdef MICROGRAD_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Clear all counters and recorded scopes (live bytes are kept: the
+    // Values still exist)
+    void reset();
+
+    // Per-scope calls / total / mean / max, node counts per op, live and
+    // peak Value bytes
+    void print_summary(std::ostream& os);
+
+    // Every recorded scope as a Chrome trace event ("ph": "X", one track per
+    // thread), with the live Value bytes as a counter track.
+    // Returns false if the file cannot be written.
+    bool write_chrome_trace(const std::string& path);
+
+    // Hooks (called through the macros below)
+    void node_created(Op op, size_t bytes);
+    void node_destroyed(size_t bytes);
+    void record(const char* name, int64_t begin_ns, int64_t end_ns);
+    int64_t now_ns();
+
+    // Times its own lifetime. name must be a string literal (it is kept)
+    struct Scope {
+        const char* name;
+        int64_t begin;
+
+        explicit Scope(const char* name) : name(name), begin(now_ns()) {}
+        ~Scope() { record(name, begin, now_ns()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
+
+#define MG_PROFILE_CONCAT_(a, b) a##b
+#define MG_PROFILE_CONCAT(a, b) MG_PROFILE_CONCAT_(a, b)
+
+#ifdef MICROGRAD_PROFILE
+#define MG_PROFILE_SCOPE(name) profiler::Scope MG_PROFILE_CONCAT(mg_profile_scope_, __LINE__)(name)
+#define MG_PROFILE_NODE_CREATED(op, bytes) profiler::node_created(op, bytes)
+#define MG_PROFILE_NODE_DESTROYED(bytes) profiler::node_destroyed(bytes)
+#else
+#define MG_PROFILE_SCOPE(name) ((void)0)
+#define MG_PROFILE_NODE_CREATED(op, bytes) ((void)0)
+#define MG_PROFILE_NODE_DESTROYED(bytes) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "Quantize.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <cmath>
+
+static const int INT8_ROW_ALIGN = 64;
+
+// Asymmetric int8 quantization of one neuron's weights. The range always
+// contains 0, so a zero weight stays exactly zero.
+static void quantize_row(const Scalar* w, int n, int8_t* q, float& scale, int32_t& zero_point, int32_t& qsum) {
+    Scalar lo = 0.0, hi = 0.0;
+    for (int i = 0; i < n; ++i) {
+        lo = std::min(lo, w[i]);
+        hi = std::max(hi, w[i]);
+    }
+    scale = hi > lo ? (float)((hi - lo) / 255.0) : 1.0f;
+    zero_point = (int32_t)std::lround(-128.0 - lo / scale);
+    zero_point = std::max(-128, std::min(127, zero_point));
+
+    qsum = 0;
+    for (int i = 0; i < n; ++i) {
+        long v = std::lround(w[i] / scale) + zero_point;
+        q[i] = (int8_t)std::max(-128L, std::min(127L, v));
+        qsum += q[i];
+    }
+}
+
+// Per-sample quantization of a layer input to [0, 127], x ~= scale * (q - zero_point)
+static void quantize_input(const Scalar* x, int n, uint8_t* q, float& scale, int32_t& zero_point, int32_t& qsum) {
+    Scalar lo = 0.0, hi = 0.0;
+    for (int i = 0; i < n; ++i) {
+        lo = std::min(lo, x[i]);
+        hi = std::max(hi, x[i]);
+    }
+    scale = hi > lo ? (float)((hi - lo) / 127.0) : 1.0f;
+    zero_point = std::max(0, std::min(127, (int32_t)std::lround(-lo / scale)));
+
+    // Clamped to [0, 127] first, so rounding is a truncation of t + 0.5
+    qsum = 0;
+    const Scalar inv = (Scalar)(1.0f / scale), zp = (Scalar)zero_point;
+    for (int i = 0; i < n; ++i) {
+        Scalar t = std::max((Scalar)0.0, std::min((Scalar)127.0, x[i] * inv + zp));
+        q[i] = (uint8_t)(int32_t)(t + (Scalar)0.5);
+        qsum += q[i];
+    }
+}
+
+// 1. Quantization
+QuantizedMLP::QuantizedMLP(const MLP& model, bool quantize_last) {
+    const Scalar* params = model.parameter_span().data;
+    _nin = (int)model.layers.front()->neurons.front()->w.size();
+    _nout = (int)model.layers.back()->neurons.size();
+
+    const size_t quantized = quantize_last ? model.layers.size() : model.layers.size() - 1;
+    for (size_t l = 0; l < model.layers.size(); ++l) {
+        const Layer& layer = *model.layers[l];
+        const int nin = (int)layer.neurons[0]->w.size();
+        const int nout = (int)layer.neurons.size();
+        const size_t count = (size_t)nout * (nin + 1);
+
+        if (l == quantized) {
+            _last_nin = nin;
+            _last_nonlin = layer.neurons[0]->nonlin;
+            _last.assign(params, params + count);
+            break;
+        }
+
+        QuantizedLayer q;
+        q.nin = nin;
+        q.nout = nout;
+        q.stride = (nin + INT8_ROW_ALIGN - 1) / INT8_ROW_ALIGN * INT8_ROW_ALIGN;
+        q.nonlin = layer.neurons[0]->nonlin;
+        q.w.assign((size_t)nout * q.stride, 0);
+        q.scale.resize(nout);
+        q.zero_point.resize(nout);
+        q.qsum.resize(nout);
+        q.bias.resize(nout);
+        for (int j = 0; j < nout; ++j) {
+            const Scalar* p = params + (size_t)j * (nin + 1);
+            quantize_row(p, nin, q.w.data() + (size_t)j * q.stride, q.scale[j], q.zero_point[j], q.qsum[j]);
+            q.bias[j] = (float)p[nin];
+        }
+        _layers.push_back(std::move(q));
+        params += count;
+    }
+}
+
+// 2. Inference
+void QuantizedMLP::predict(const Scalar* x, Scalar* out) const {
+    // Dequantized activations (ping-pong) and the quantized layer input
+    static thread_local std::vector<Scalar> buf[2];
+    static thread_local std::vector<uint8_t> xq;
+
+    const Scalar* in = x;
+    for (size_t l = 0; l < _layers.size(); ++l) {
+        const QuantizedLayer& q = _layers[l];
+        Scalar* dst = out;
+        if (l + 1 < _layers.size() || !_last.empty()) {
+            std::vector<Scalar>& b = buf[l % 2];
+            if (b.size() < (size_t)q.nout) b.resize(q.nout);
+            dst = b.data();
+        }
+
+        // Padding past nin stays 0, matching the zero-padded weights
+        if (xq.size() < (size_t)q.stride) xq.resize(q.stride, 0);
+        float sx;
+        int32_t zx, xsum;
+        quantize_input(in, q.nin, xq.data(), sx, zx, xsum);
+        std::fill(xq.begin() + q.nin, xq.begin() + q.stride, 0);
+
+        // sum (xq - zx)(wq - zw) = sum xq wq - zw sum xq - zx sum wq + n zx zw
+        for (int j = 0; j < q.nout; ++j) {
+            const int32_t zw = q.zero_point[j];
+            int32_t acc = kernels::dot_u8s8(q.stride, xq.data(), q.w.data() + (size_t)j * q.stride);
+            acc += q.nin * zx * zw - zw * xsum - zx * q.qsum[j];
+            Scalar y = (Scalar)(sx * q.scale[j]) * (Scalar)acc + q.bias[j];
+            dst[j] = (q.nonlin && y < 0) ? 0.0 : y;
+        }
+        in = dst;
+    }
+
+    if (!_last.empty()) {
+        Layer::predict(_last.data(), _last_nin, _nout, _last_nonlin, in, out);
+    }
+}
+
+size_t QuantizedMLP::size_bytes() const {
+    size_t bytes = _last.size() * sizeof(Scalar);
+    for (const QuantizedLayer& q : _layers) {
+        bytes += (size_t)q.nout * q.nin * sizeof(int8_t); // padding not counted
+        bytes += (size_t)q.nout * (sizeof(float) * 2 + sizeof(int32_t) * 2);
+    }
+    return bytes;
+}
+
+// 3. Accuracy report
+QuantizationReport compare_quantized(const MLP& model, const QuantizedMLP& quantized, const std::shared_ptr<Tensor>& X) {
+    QuantizationReport r;
+    const int N = X->rows, nout = quantized.nout();
+    std::vector<Scalar> y(nout), out(nout);
+
+    double sum_abs = 0.0, sum_sq = 0.0, ref_sq = 0.0;
+    size_t agree = 0;
+    for (int i = 0; i < N; ++i) {
+        const Scalar* x = X->data.data() + (size_t)i * X->cols;
+        model.predict(x, y.data());
+        quantized.predict(x, out.data());
+
+        for (int j = 0; j < nout; ++j) {
+            double e = std::fabs((double)out[j] - (double)y[j]);
+            r.max_abs_error = std::max(r.max_abs_error, e);
+            sum_abs += e;
+            sum_sq += e * e;
+            ref_sq += (double)y[j] * y[j];
+        }
+        if (nout == 1) {
+            agree += (out[0] > 0) == (y[0] > 0);
+        }
+        else {
+            agree += std::max_element(out.begin(), out.end()) - out.begin() == std::max_element(y.begin(), y.end()) - y.begin();
+        }
+    }
+
+    const double n = (double)N * nout;
+    r.samples = (size_t)N;
+    r.mean_abs_error = N ? sum_abs / n : 0.0;
+    r.rmse = N ? std::sqrt(sum_sq / n) : 0.0;
+    r.reference_rms = N ? std::sqrt(ref_sq / n) : 0.0;
+    r.agreement = N ? (double)agree / N : 0.0;
+    r.model_bytes = model.num_parameters() * sizeof(Scalar);
+    r.quantized_bytes = quantized.size_bytes();
+    return r;
+}
+
+std::ostream& operator<<(std::ostream& os, const QuantizationReport& r) {
+    os << "int8 (" << kernels::isa_int8() << ") vs MLP::predict (Scalar) over " << r.samples << " samples:\n"
+       << "  max |error|   " << r.max_abs_error << "\n"
+       << "  mean |error|  " << r.mean_abs_error << "\n"
+       << "  RMSE          " << r.rmse << " (reference RMS " << r.reference_rms << ")\n"
+       << "  agreement     " << r.agreement * 100.0 << "%\n"
+       << "  size          " << r.model_bytes << " -> " << r.quantized_bytes << " bytes";
+    return os;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "MLP.h"
+#include "Tensor.h"
+
+// --------------------------------------------------------------------------
+// INT8 INFERENCE
+// --------------------------------------------------------------------------
+// Post-training quantization of a trained MLP for serving.
+//
+// Every neuron's weights become int8 with their own scale and zero point,
+// w ~= scale * (q - zero_point), so a layer takes a quarter of the memory
+// of float weights (an eighth of double). At inference each layer's input
+// is quantized on the fly to 7-bit unsigned values with a per-sample scale,
+// the dot products run in int32 (kernels::dot_u8s8: AVX-512 VNNI, AVX-VNNI,
+// AVX2 vpmaddubsw or scalar) and the result is dequantized, biased and
+// activated in float. The last layer, whose outputs are the predictions,
+// is by default not quantized: the hidden activations are dequantized and
+// it runs on the original weights.
+//
+//     QuantizedMLP q(model);
+//     q.predict(x, out);
+//     std::cout << compare_quantized(model, q, X_validation);
+
+struct QuantizedLayer {
+    int nin = 0;
+    int nout = 0;
+    int stride = 0;                  // nin rounded up to 64, the row length of w
+    bool nonlin = false;
+    std::vector<int8_t> w;           // nout x stride, zero padded
+    std::vector<float> scale;        // per neuron
+    std::vector<int32_t> zero_point; // per neuron
+    std::vector<int32_t> qsum;       // per neuron: sum of its q over the nin inputs
+    std::vector<float> bias;
+};
+
+class QuantizedMLP {
+  public:
+    // quantize_last: also quantize the output layer (smaller, less accurate)
+    explicit QuantizedMLP(const MLP& model, bool quantize_last = false);
+
+    // Writes the nout outputs for one input of nin values.
+    // No heap allocation once the calling thread has run it once.
+    void predict(const Scalar* x, Scalar* out) const;
+
+    int nin() const { return _nin; }
+    int nout() const { return _nout; }
+
+    // Bytes of weights, biases and quantization constants
+    size_t size_bytes() const;
+
+  private:
+    int _nin = 0;
+    int _nout = 0;
+    std::vector<QuantizedLayer> _layers;
+
+    // Output layer kept in Scalar: nout rows of [w..., b], as in the MLP
+    int _last_nin = 0;
+    bool _last_nonlin = false;
+    std::vector<Scalar> _last;
+};
+
+// Accuracy of a QuantizedMLP against the MLP it came from, as run by
+// MLP::predict in Scalar precision (float in a MICROGRAD_FLOAT build)
+struct QuantizationReport {
+    size_t samples = 0;
+    double max_abs_error = 0.0;
+    double mean_abs_error = 0.0;
+    double rmse = 0.0;
+    double reference_rms = 0.0; // RMS of the reference outputs, for scale
+    double agreement = 0.0;     // fraction of samples with the same argmax (same sign if nout == 1)
+    size_t model_bytes = 0;     // the MLP's parameters
+    size_t quantized_bytes = 0; // QuantizedMLP::size_bytes()
+};
+
+// Runs every row of X (N x nin) through both models, one predict() each
+QuantizationReport compare_quantized(const MLP& model, const QuantizedMLP& quantized, const std::shared_ptr<Tensor>& X);
+
+std::ostream& operator<<(std::ostream& os, const QuantizationReport& r);
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// --------------------------------------------------------------------------
+// SCALAR TYPE
+// --------------------------------------------------------------------------
+// The floating-point type of every value, gradient, parameter and tensor
+// element in the engine. double by default; building with MICROGRAD_FLOAT
+// defined (CMake: -DMICROGRAD_SCALAR=float) switches the whole engine to
+// float, which doubles the SIMD width of the kernels and halves the memory
+// traffic of every pass.
+//
+// Checkpoints record sizeof(Scalar) and only load into a build of the
+// same precision.
+
+#ifdef MICROGRAD_FLOAT
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
+// --------------------------------------------------------------------------
+// BF16
+// --------------------------------------------------------------------------
+// bfloat16: the top 16 bits of a float32 (same exponent range, 8-bit
+// mantissa). A storage format only: values are widened to Scalar before
+// any arithmetic. Used for activations kept across the forward/backward
+// pass (see Tensor::checkpoint), at a quarter of the size of a double.
+
+struct bf16 {
+    uint16_t bits = 0;
+
+    bf16() = default;
+    explicit bf16(float f) {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        if ((u & 0x7fffffffu) > 0x7f800000u) {
+            bits = (uint16_t)((u >> 16) | 0x40); // NaN stays a (quiet) NaN
+        }
+        else {
+            u += 0x7fffu + ((u >> 16) & 1u); // round to nearest even
+            bits = (uint16_t)(u >> 16);
+        }
+    }
+
+    operator float() const {
+        uint32_t u = (uint32_t)bits << 16;
+        float f;
+        std::memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+};
+static_assert(sizeof(bf16) == 2, "bf16 must stay 2 bytes");
+
+// --------------------------------------------------------------------------
+// ATOMIC ACCUMULATION
+// --------------------------------------------------------------------------
+// target += v from several threads at once, on a slot that is an ordinary
+// Scalar everywhere else; atomic_read() reads such a slot while others add
+// to it. C++17 has no atomic operation on a plain object
+// (std::atomic_ref is C++20), so:
+//   1. C++20: std::atomic_ref
+//   2. GCC / Clang: the __atomic builtins, which take any address
+//   3. MSVC in C++17: the slot is accessed as a std::atomic<Scalar>. This is
+//      not standard C++; it relies on MSVC's lock-free std::atomic of a
+//      double/float being exactly the bare value.
+
+#if defined(__cpp_lib_atomic_ref)
+
+inline void atomic_add(Scalar& target, Scalar v) {
+    std::atomic_ref<Scalar>(target).fetch_add(v, std::memory_order_relaxed);
+}
+
+inline Scalar atomic_read(Scalar& source) {
+    return std::atomic_ref<Scalar>(source).load(std::memory_order_relaxed);
+}
+
+#elif defined(__GNUC__)
+
+inline void atomic_add(Scalar& target, Scalar v) {
+    Scalar cur, next;
+    __atomic_load(&target, &cur, __ATOMIC_RELAXED);
+    do {
+        next = cur + v;
+    } while (!__atomic_compare_exchange(&target, &cur, &next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+inline Scalar atomic_read(Scalar& source) {
+    Scalar cur;
+    __atomic_load(&source, &cur, __ATOMIC_RELAXED);
+    return cur;
+}
+
+#else
+
+inline void atomic_add(Scalar& target, Scalar v) {
+    static_assert(std::atomic<Scalar>::is_always_lock_free, "atomic Scalar must be lock-free");
+    static_assert(sizeof(std::atomic<Scalar>) == sizeof(Scalar), "atomic Scalar must have the layout of Scalar");
+    std::atomic<Scalar>& slot = reinterpret_cast<std::atomic<Scalar>&>(target);
+    Scalar cur = slot.load(std::memory_order_relaxed);
+    while (!slot.compare_exchange_weak(cur, cur + v, std::memory_order_relaxed)) {
+    }
+}
+
+inline Scalar atomic_read(Scalar& source) {
+    return reinterpret_cast<std::atomic<Scalar>&>(source).load(std::memory_order_relaxed);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,387 @@
+#include "Server.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static const size_t LATENCY_WINDOW = (size_t)1 << 16;
+
+// --------------------------------------------------------------------------
+// SOCKETS
+// --------------------------------------------------------------------------
+// The few calls needed, over BSD sockets and Winsock. Handles are kept as
+// intptr_t (a SOCKET on Windows, a file descriptor elsewhere); -1 is
+// invalid on both. Wire values are sent as they are in memory: every
+// supported target is little endian.
+
+#ifdef _WIN32
+typedef SOCKET socket_t;
+static void close_socket(intptr_t s) { closesocket((socket_t)s); }
+static void shutdown_socket(intptr_t s) { shutdown((socket_t)s, SD_BOTH); }
+
+static void net_init() {
+    static const bool started = []() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started) throw std::runtime_error("server: WSAStartup failed");
+}
+#else
+typedef int socket_t;
+static void close_socket(intptr_t s) { close((socket_t)s); }
+static void shutdown_socket(intptr_t s) { shutdown((socket_t)s, SHUT_RDWR); }
+static void net_init() {}
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL; // a closed peer is an error, not SIGPIPE
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+static bool send_all(intptr_t s, const void* data, size_t bytes) {
+    const char* p = (const char*)data;
+    while (bytes > 0) {
+        int n = (int)send((socket_t)s, p, (int)std::min(bytes, (size_t)1 << 20), SEND_FLAGS);
+        if (n <= 0) return false;
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return true;
+}
+
+static bool recv_all(intptr_t s, void* data, size_t bytes) {
+    char* p = (char*)data;
+    while (bytes > 0) {
+        int n = (int)recv((socket_t)s, p, (int)std::min(bytes, (size_t)1 << 20), 0);
+        if (n <= 0) return false;
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return true;
+}
+
+// Requests and responses are small: send them at once, without Nagle's delay
+static void set_nodelay(intptr_t s) {
+    int on = 1;
+    setsockopt((socket_t)s, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on));
+}
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// --------------------------------------------------------------------------
+// SERVER
+// --------------------------------------------------------------------------
+
+// 1. Constructor
+InferenceServer::InferenceServer(MLP& model, ServerOptions options)
+    : _model(model), _options(options)
+{
+    _nin = (int)model.layers.front()->neurons.front()->w.size();
+    _nout = (int)model.layers.back()->neurons.size();
+    _options.max_batch = std::max(1, _options.max_batch);
+    _options.max_delay_us = std::max(0, _options.max_delay_us);
+
+    net_init();
+    socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if ((intptr_t)s == -1) throw std::runtime_error("server: cannot create a socket");
+    _listen = (intptr_t)s;
+#ifndef _WIN32
+    int on = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+#endif
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)_options.port);
+    socklen_t len = sizeof(addr);
+    if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, SOMAXCONN) != 0 ||
+        getsockname(s, (sockaddr*)&addr, &len) != 0) {
+        close_socket(_listen);
+        throw std::runtime_error("server: cannot listen on 127.0.0.1:" + std::to_string(_options.port));
+    }
+    _port = ntohs(addr.sin_port);
+
+    _latencies.reserve(LATENCY_WINDOW);
+    _start_ns = now_ns();
+    _batcher = std::thread([this]() { batch_loop(); });
+    _acceptor = std::thread([this]() { accept_loop(); });
+}
+
+InferenceServer::~InferenceServer() {
+    stop();
+}
+
+void InferenceServer::stop() {
+    if (_stop.exchange(true)) return;
+
+    // The batcher answers the requests still queued with a failure, so no
+    // connection thread is left waiting
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _queued.notify_all();
+    _batcher.join();
+    _acceptor.join();
+    close_socket(_listen);
+
+    // Unblock connections waiting in recv(); they close their own sockets
+    {
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        for (Connection& c : _connections) {
+            if (!c.finished) shutdown_socket(c.socket);
+        }
+    }
+    // The acceptor is gone: nothing else modifies the list
+    for (Connection& c : _connections) {
+        c.thread.join();
+    }
+    _connections.clear();
+}
+
+// 2. Connections
+void InferenceServer::accept_loop() {
+    while (!_stop) {
+        // Poll, so stop() is seen within 100 ms
+        fd_set ready;
+        FD_ZERO(&ready);
+        FD_SET((socket_t)_listen, &ready);
+        timeval timeout = { 0, 100000 };
+        if (select((int)_listen + 1, &ready, nullptr, nullptr, &timeout) <= 0) continue;
+
+        socket_t s = accept((socket_t)_listen, nullptr, nullptr);
+        if ((intptr_t)s == -1) continue;
+        set_nodelay((intptr_t)s);
+
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        for (auto it = _connections.begin(); it != _connections.end();) {
+            if (it->finished) {
+                it->thread.join();
+                it = _connections.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        _connections.emplace_back();
+        Connection& c = _connections.back();
+        c.socket = (intptr_t)s;
+        c.thread = std::thread([this, &c]() { serve(c); });
+    }
+}
+
+void InferenceServer::serve(Connection& c) {
+    std::vector<float> x(_nin), out(_nout);
+    const uint32_t nout = (uint32_t)_nout;
+
+    while (true) {
+        uint32_t n;
+        if (!recv_all(c.socket, &n, sizeof(n))) break;
+        if (n != (uint32_t)_nin) {
+            const uint32_t rejected = 0;
+            send_all(c.socket, &rejected, sizeof(rejected));
+            break;
+        }
+        if (!recv_all(c.socket, x.data(), x.size() * sizeof(float))) break;
+
+        Pending p{ x.data(), out.data(), now_ns() };
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_stop) break;
+            _queue.push_back(&p);
+            _queued.notify_one();
+            _served.wait(lock, [&]() { return p.done; });
+        }
+        if (_stop) break;
+        if (p.failed) {
+            const uint32_t rejected = 0;
+            send_all(c.socket, &rejected, sizeof(rejected));
+            break;
+        }
+
+        if (!send_all(c.socket, &nout, sizeof(nout)) || !send_all(c.socket, out.data(), out.size() * sizeof(float))) break;
+
+        const int64_t latency = now_ns() - p.received_ns;
+        std::lock_guard<std::mutex> lock(_stats_mutex);
+        if (_latencies.size() < LATENCY_WINDOW) {
+            _latencies.push_back(latency);
+        }
+        else {
+            _latencies[_latency_next] = latency;
+            _latency_next = (_latency_next + 1) % LATENCY_WINDOW;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+    close_socket(c.socket);
+    c.finished = true;
+}
+
+// 3. Batching
+void InferenceServer::batch_loop() {
+    std::vector<Pending*> batch;
+    std::vector<Scalar> X, Y;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queued.wait(lock, [&]() { return _stop || !_queue.empty(); });
+            if (_stop) break;
+
+            // Full batch or the oldest request's deadline, whichever is first
+            const auto deadline = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(
+                _queue.front()->received_ns + (int64_t)_options.max_delay_us * 1000));
+            _queued.wait_until(lock, deadline, [&]() { return _stop || (int)_queue.size() >= _options.max_batch; });
+            if (_stop) break;
+
+            const size_t rows = std::min(_queue.size(), (size_t)_options.max_batch);
+            batch.assign(_queue.begin(), _queue.begin() + rows);
+            _queue.erase(_queue.begin(), _queue.begin() + rows);
+        }
+
+        // One batched inference pass, outside the lock. It builds no graph;
+        // if it still fails (e.g. bad_alloc), the batch's requests fail
+        // rather than the exception ending the thread.
+        const int rows = (int)batch.size();
+        bool failed = false;
+        try {
+            X.resize((size_t)rows * _nin);
+            Y.resize((size_t)rows * _nout);
+            for (int r = 0; r < rows; ++r) {
+                std::copy(batch[r]->x, batch[r]->x + _nin, X.begin() + (size_t)r * _nin);
+            }
+            _model.predict(X.data(), rows, Y.data());
+            for (int r = 0; r < rows; ++r) {
+                const Scalar* y = Y.data() + (size_t)r * _nout;
+                std::copy(y, y + _nout, batch[r]->out);
+            }
+        }
+        catch (const std::exception&) {
+            failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (Pending* p : batch) {
+                p->failed = failed;
+                p->done = true;
+            }
+        }
+        _served.notify_all();
+        if (failed) continue;
+
+        std::lock_guard<std::mutex> lock(_stats_mutex);
+        _requests += (uint64_t)rows;
+        ++_batches;
+    }
+
+    // Stopping: release whoever is still waiting (their requests fail)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Pending* p : _queue) p->done = true;
+        _queue.clear();
+    }
+    _served.notify_all();
+}
+
+// 4. Stats
+ServerStats InferenceServer::stats() const {
+    ServerStats s;
+    std::vector<int64_t> latencies;
+    {
+        std::lock_guard<std::mutex> lock(_stats_mutex);
+        s.requests = _requests;
+        s.batches = _batches;
+        s.seconds = (now_ns() - _start_ns) / 1e9;
+        latencies = _latencies;
+    }
+    s.qps = s.seconds > 0 ? s.requests / s.seconds : 0.0;
+    s.mean_batch = s.batches ? (double)s.requests / s.batches : 0.0;
+
+    if (!latencies.empty()) {
+        auto percentile = [&](double q) {
+            auto it = latencies.begin() + (size_t)(q * (latencies.size() - 1));
+            std::nth_element(latencies.begin(), it, latencies.end());
+            return *it / 1e3;
+        };
+        s.p50_us = percentile(0.50);
+        s.p99_us = percentile(0.99);
+        s.max_us = *std::max_element(latencies.begin(), latencies.end()) / 1e3;
+    }
+    return s;
+}
+
+void InferenceServer::reset_stats() {
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+    _start_ns = now_ns();
+    _requests = 0;
+    _batches = 0;
+    _latencies.clear();
+    _latency_next = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const ServerStats& s) {
+    os << s.requests << " requests in " << s.seconds << " s: " << s.qps << " req/s, "
+       << s.batches << " batches (mean " << s.mean_batch << " rows), latency p50 " << s.p50_us
+       << " us, p99 " << s.p99_us << " us, max " << s.max_us << " us";
+    return os;
+}
+
+// --------------------------------------------------------------------------
+// CLIENT
+// --------------------------------------------------------------------------
+
+InferenceClient::InferenceClient(int port) {
+    net_init();
+    socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if ((intptr_t)s == -1) throw std::runtime_error("server: cannot create a socket");
+    _socket = (intptr_t)s;
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close_socket(_socket);
+        throw std::runtime_error("server: cannot connect to 127.0.0.1:" + std::to_string(port));
+    }
+    set_nodelay(_socket);
+}
+
+InferenceClient::~InferenceClient() {
+    close_socket(_socket);
+}
+
+void InferenceClient::predict(const std::vector<float>& x, std::vector<float>& out) {
+    const uint32_t n = (uint32_t)x.size();
+    uint32_t nout;
+    if (!send_all(_socket, &n, sizeof(n)) || !send_all(_socket, x.data(), x.size() * sizeof(float)) ||
+        !recv_all(_socket, &nout, sizeof(nout))) {
+        throw std::runtime_error("server: connection lost");
+    }
+    if (nout == 0) {
+        throw std::runtime_error("server: request rejected (" + std::to_string(n) + " features: wrong input size, or the batch failed)");
+    }
+    out.resize(nout);
+    if (!recv_all(_socket, out.data(), out.size() * sizeof(float))) {
+        throw std::runtime_error("server: connection lost");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MLP.h"
+
+// --------------------------------------------------------------------------
+// INFERENCE SERVER
+// --------------------------------------------------------------------------
+// Serves an MLP on a loopback TCP port (127.0.0.1 only), batching
+// requests dynamically: requests from all connections queue up, and one
+// batched, graph-free MLP::predict runs as soon as max_batch of them are
+// waiting or the oldest has waited max_delay_us, whichever comes first.
+// A larger batch uses the blocked matmul kernels better; a longer
+// deadline fills larger batches at the price of latency.
+//
+// Wire format (little endian, any number of requests per connection):
+//     request   uint32 n = nin,  n x float32 features
+//     response  uint32 n = nout, n x float32 outputs
+// A request of the wrong size, or one whose batch failed, gets a response
+// with n = 0 and the connection is closed.
+//
+//     InferenceServer server(model, { 0, 64, 500 }); // any free port
+//     InferenceClient client(server.port());
+//     client.predict(x, out);
+//     std::cout << server.stats();
+//
+// The model must not be trained while the server runs.
+
+struct ServerOptions {
+    int port = 0;             // 0: any free port (see InferenceServer::port())
+    int max_batch = 64;       // rows per forward pass
+    int max_delay_us = 500;   // longest a request waits for its batch to fill
+};
+
+// Counters since start (or reset_stats()); latencies are from a request
+// being read to its response being sent, over the last 64k requests
+struct ServerStats {
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    double seconds = 0.0;
+    double qps = 0.0;
+    double mean_batch = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+std::ostream& operator<<(std::ostream& os, const ServerStats& s);
+
+class InferenceServer {
+  public:
+    // Binds and starts serving; throws std::runtime_error if the port is taken
+    InferenceServer(MLP& model, ServerOptions options = ServerOptions());
+    ~InferenceServer(); // stops
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    int port() const { return _port; }
+
+    // Closes the listening socket and every connection, waits for the threads
+    void stop();
+
+    ServerStats stats() const;
+    void reset_stats();
+
+  private:
+    // One queued request; the connection thread waits for 'done'
+    struct Pending {
+        const float* x;
+        float* out;
+        int64_t received_ns;
+        bool done = false;
+        bool failed = false; // the batch's forward pass threw
+    };
+
+    struct Connection {
+        intptr_t socket;
+        std::thread thread;
+        std::atomic<bool> finished{ false };
+    };
+
+    MLP& _model;
+    ServerOptions _options;
+    int _nin = 0;
+    int _nout = 0;
+    int _port = 0;
+    intptr_t _listen = -1;
+
+    std::atomic<bool> _stop{ false };
+    std::thread _acceptor;
+    std::thread _batcher;
+    std::mutex _connections_mutex;
+    std::list<Connection> _connections;
+
+    // Request queue
+    std::mutex _mutex;
+    std::condition_variable _queued; // batcher: requests arrived
+    std::condition_variable _served; // connections: a batch finished
+    std::deque<Pending*> _queue;
+
+    // Stats
+    mutable std::mutex _stats_mutex;
+    int64_t _start_ns = 0;
+    uint64_t _requests = 0;
+    uint64_t _batches = 0;
+    std::vector<int64_t> _latencies; // ring of the last LATENCY_WINDOW
+    size_t _latency_next = 0;
+
+    void accept_loop();
+    void serve(Connection& c);
+    void batch_loop();
+};
+
+// Blocking client for one connection (e.g. per thread)
+class InferenceClient {
+  public:
+    // Connects to 127.0.0.1:port; throws std::runtime_error on failure
+    explicit InferenceClient(int port);
+    ~InferenceClient();
+
+    InferenceClient(const InferenceClient&) = delete;
+    InferenceClient& operator=(const InferenceClient&) = delete;
+
+    // out.size() becomes the server's nout; throws std::runtime_error if the
+    // server rejects the request or the connection drops
+    void predict(const std::vector<float>& x, std::vector<float>& out);
+
+  private:
+    intptr_t _socket = -1;
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "Sparse.h"
+#include "Kernels.h"
+#include "Neuron.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// --------------------------------------------------------------------------
+// SPARSE BATCH
+// --------------------------------------------------------------------------
+
+void SparseBatch::add_row(const int32_t* idx, const Scalar* val, int nnz) {
+    for (int k = 0; k < nnz; ++k) {
+        if (idx[k] < 0 || idx[k] >= cols) {
+            throw std::runtime_error("sparse: index " + std::to_string(idx[k]) + " out of range for " +
+                                     std::to_string(cols) + " columns");
+        }
+    }
+    index.insert(index.end(), idx, idx + nnz);
+    value.insert(value.end(), val, val + nnz);
+    offsets.push_back(index.size());
+}
+
+void SparseBatch::clear() {
+    offsets.assign(1, 0);
+    index.clear();
+    value.clear();
+}
+
+// --------------------------------------------------------------------------
+// SPARSE LINEAR
+// --------------------------------------------------------------------------
+
+// 1. Constructor
+SparseLinear::SparseLinear(int nin, int nout, bool nonlin)
+    : nin(nin), nout(nout), nonlin(nonlin),
+      weight((size_t)nin * nout), bias(nout), bias_grad(nout, 0.0), _slot(nin, -1)
+{
+    for (Scalar& w : weight) w = (Scalar)random_uniform();
+    for (Scalar& b : bias) b = (Scalar)random_uniform();
+}
+
+// 2. Forward Pass
+std::shared_ptr<Tensor> SparseLinear::operator()(const SparseBatch& x) {
+    if (x.cols != nin) {
+        throw std::runtime_error("sparse: batch of " + std::to_string(x.cols) + " columns for a layer of " +
+                                 std::to_string(nin) + " inputs");
+    }
+    const int rows = x.rows();
+    auto out = std::make_shared<Tensor>(rows, nout, std::vector<std::shared_ptr<Tensor>>{}, "sparse");
+
+    // out[r] = b + sum_k value_k * W[index_k]: one row of W per non-zero
+    for (int r = 0; r < rows; ++r) {
+        Scalar* o = out->data.data() + (size_t)r * nout;
+        std::copy(bias.begin(), bias.end(), o);
+        for (size_t k = x.offsets[r]; k < x.offsets[r + 1]; ++k) {
+            kernels::axpy(nout, x.value[k], weight.data() + (size_t)x.index[k] * nout, o);
+        }
+    }
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [this, x, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (!out_ptr) return;
+        for (int r = 0; r < x.rows(); ++r) {
+            const Scalar* d = out_ptr->grad.data() + (size_t)r * nout;
+            kernels::axpy(nout, 1.0, d, bias_grad.data());
+            for (size_t k = x.offsets[r]; k < x.offsets[r + 1]; ++k) {
+                kernels::axpy(nout, x.value[k], d, grad_row(x.index[k]));
+            }
+        }
+        };
+    return nonlin ? out->relu() : out;
+}
+
+// 3. Inference
+void SparseLinear::predict(const int32_t* idx, const Scalar* val, int nnz, Scalar* out) const {
+    std::copy(bias.begin(), bias.end(), out);
+    for (int k = 0; k < nnz; ++k) {
+        kernels::axpy(nout, val[k], weight.data() + (size_t)idx[k] * nout, out);
+    }
+    if (nonlin) {
+        for (int j = 0; j < nout; ++j) out[j] = out[j] < 0 ? 0.0 : out[j];
+    }
+}
+
+// 4. Sparse gradient
+Scalar* SparseLinear::grad_row(int32_t row) {
+    if (_slot[row] < 0) {
+        _slot[row] = (int32_t)_touched.size();
+        _touched.push_back(row);
+        _grad.resize(_touched.size() * nout, 0.0);
+    }
+    return _grad.data() + (size_t)_slot[row] * nout;
+}
+
+const Scalar* SparseLinear::row_grad(int32_t row) const {
+    return _slot[row] < 0 ? nullptr : _grad.data() + (size_t)_slot[row] * nout;
+}
+
+void SparseLinear::zero_grad() {
+    for (int32_t row : _touched) _slot[row] = -1;
+    _touched.clear();
+    _grad.clear(); // keeps its capacity
+    std::fill(bias_grad.begin(), bias_grad.end(), 0.0);
+}
+
+void SparseLinear::sgd_step(Scalar lr) {
+    for (size_t s = 0; s < _touched.size(); ++s) {
+        kernels::axpy(nout, -lr, _grad.data() + s * nout, weight.data() + (size_t)_touched[s] * nout);
+    }
+    kernels::axpy(nout, -lr, bias_grad.data(), bias.data());
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Tensor.h"
+
+// --------------------------------------------------------------------------
+// SPARSE INPUTS
+// --------------------------------------------------------------------------
+// For inputs such as hashed categorical features: 1e5 - 1e6 dimensions with
+// a few dozen non-zeros per sample. A dense first Layer would need one
+// Value per weight (1e6 x nout of them) and would touch every one of them
+// per sample; SparseLinear keeps its weights in a plain array and only
+// reads and updates the rows of the features that are present, so a
+// forward or backward pass costs O(nnz x nout) whatever the dimension.
+//
+// SparseLinear takes the place of the first layer and hands a dense
+// Tensor to an ordinary MLP for the rest of the network:
+//
+//     SparseLinear embed(1 << 20, 64);      // ReLU, like a hidden Layer
+//     MLP head(64, { 64, 1 });
+//     SGD optimizer(head, lr);
+//
+//     auto loss = head(embed(batch))->sub(Y)->pow(2)->sum();
+//     optimizer.zero_grad();
+//     embed.zero_grad();
+//     loss->backward();
+//     optimizer.step();
+//     embed.sgd_step(lr);                   // only the rows that were hit
+
+// A batch of sparse rows in CSR form: row r is the entries
+// [offsets[r], offsets[r + 1]) of index/value
+struct SparseBatch {
+    int cols = 0;                          // dimension of a row
+    std::vector<size_t> offsets = { 0 };
+    std::vector<int32_t> index;
+    std::vector<Scalar> value;
+
+    explicit SparseBatch(int cols = 0) : cols(cols) {}
+
+    int rows() const { return (int)offsets.size() - 1; }
+    size_t nnz() const { return index.size(); }
+
+    // Appends a row of nnz (index, value) pairs, in any order.
+    // Throws std::runtime_error for an index outside [0, cols).
+    void add_row(const int32_t* idx, const Scalar* val, int nnz);
+    void clear();
+};
+
+struct SparseLinear {
+    int nin;
+    int nout;
+    bool nonlin;
+
+    // Weights stored by input: row i (nout Scalars) holds the weights of
+    // input i for every output, so a present feature is one contiguous row
+    std::vector<Scalar> weight; // nin x nout
+    std::vector<Scalar> bias;   // nout
+    std::vector<Scalar> bias_grad;
+
+    // Weights and bias uniform in [-1, 1), like a Layer
+    SparseLinear(int nin, int nout, bool nonlin = true);
+
+    // out (rows x nout) = act(x W + b) as one Tensor graph node (a leaf:
+    // x is data, not a Tensor). backward() through it adds the weight
+    // gradients of the rows x uses into the sparse gradient below.
+    // The layer must outlive the graph.
+    std::shared_ptr<Tensor> operator()(const SparseBatch& x);
+
+    // Inference for one row, no graph
+    void predict(const int32_t* idx, const Scalar* val, int nnz, Scalar* out) const;
+
+    // Sparse gradient: only the weight rows hit since the last zero_grad()
+    size_t touched_rows() const { return _touched.size(); }
+    const Scalar* row_grad(int32_t row) const; // nout Scalars, nullptr if not touched
+
+    // Forget the gradient; O(touched rows)
+    void zero_grad();
+
+    // weight -= lr * grad on the touched rows, and the bias
+    void sgd_step(Scalar lr);
+
+    size_t num_parameters() const { return weight.size() + bias.size(); }
+
+  private:
+    std::vector<int32_t> _slot;      // per input row: its slot in _grad, -1 if not touched
+    std::vector<int32_t> _touched;   // touched rows, in slot order
+    std::vector<Scalar> _grad;       // touched rows' gradients, nout per slot
+
+    Scalar* grad_row(int32_t row);   // the row's slot, added (zeroed) on first use
+};
\ No newline at end of file
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "MLP.h"
+
+// --------------------------------------------------------------------------
+// STATIC MLP
+// --------------------------------------------------------------------------
+// An MLP whose architecture is fixed at compile time, for tiny models where
+// the dynamic Layer/Neuron/Value structure costs far more than the math:
+// StaticMLP<3, 4, 4, 1> is MLP(3, {4, 4, 1}).
+//
+// The parameters are one std::array in the same layout as the MLP's
+// ParameterStore (per neuron [w..., b], layer after layer), so importing
+// and exporting is a copy. Every loop bound is a constant, one function
+// per layer, no graph: the compiler unrolls and inlines the whole forward
+// and backward pass. ReLU on every layer except the last, as in MLP.
+//
+//     StaticMLP<3, 4, 4, 1> head(model);    // weights from a trained MLP
+//     head.predict(x, &y);
+//
+//     head.zero_grad();                     // or train it directly
+//     for (...) loss += head.train_sample(x, y);
+//     head.sgd_step(0.05);
+//     head.export_to(model);
+
+template <int... Sizes>
+struct StaticMLP {
+    static_assert(sizeof...(Sizes) >= 2, "StaticMLP needs an input size and at least one layer");
+
+    static constexpr int num_layers = (int)sizeof...(Sizes) - 1;
+    static constexpr std::array<int, sizeof...(Sizes)> sizes = { Sizes... };
+    static constexpr int nin = sizes[0];
+    static constexpr int nout = sizes[num_layers];
+
+    // Start of layer L's parameters / of its input in the activations
+    static constexpr int param_offset(int L) {
+        int offset = 0;
+        for (int l = 0; l < L; ++l) offset += sizes[l + 1] * (sizes[l] + 1);
+        return offset;
+    }
+    static constexpr int activation_offset(int L) {
+        int offset = 0;
+        for (int l = 0; l < L; ++l) offset += sizes[l];
+        return offset;
+    }
+    static constexpr int max_width() {
+        int width = 0;
+        for (int s : sizes) width = s > width ? s : width;
+        return width;
+    }
+
+    static constexpr int num_parameters = param_offset(num_layers);
+
+    std::array<Scalar, num_parameters> data{};
+    std::array<Scalar, num_parameters> grad{};
+
+    // Random weights and biases in [-1, 1), like a new MLP
+    StaticMLP() {
+        for (Scalar& p : data) p = (Scalar)random_uniform();
+    }
+
+    explicit StaticMLP(const MLP& model) {
+        import_from(model);
+    }
+
+    // 1. Import / export
+    // Throws std::runtime_error unless model has exactly this architecture
+    void import_from(const MLP& model) {
+        check(model);
+        const ParameterSpan span = model.parameter_span();
+        std::copy(span.data, span.data + num_parameters, data.begin());
+    }
+
+    void export_to(MLP& model) const {
+        check(model);
+        const ParameterSpan span = model.parameter_span();
+        std::copy(data.begin(), data.end(), span.data);
+    }
+
+    // A new dynamic MLP holding these weights
+    MLP to_mlp() const {
+        MLP model(nin, std::vector<int>(sizes.begin() + 1, sizes.end()));
+        export_to(model);
+        return model;
+    }
+
+    // 2. Inference: no state touched, nothing allocated
+    void predict(const Scalar* x, Scalar* out) const {
+        std::array<Scalar, max_width()> buf[2];
+        predict_layers(x, out, buf, std::make_integer_sequence<int, num_layers>());
+    }
+
+    // 3. Training on one sample at a time
+    // Forward pass keeping every layer's activations for backward()
+    void forward(const Scalar* x, Scalar* out) {
+        std::copy(x, x + nin, _act.begin());
+        forward_layers(std::make_integer_sequence<int, num_layers>());
+        const Scalar* y = _act.data() + activation_offset(num_layers);
+        std::copy(y, y + nout, out);
+    }
+
+    // Adds d(loss)/d(param) into grad, given dout = d(loss)/d(output) of the
+    // last forward()
+    void backward(const Scalar* dout) {
+        std::array<Scalar, max_width()> buf[2];
+        std::copy(dout, dout + nout, buf[num_layers % 2].begin());
+        backward_layers(buf, std::make_integer_sequence<int, num_layers>());
+    }
+
+    // forward + backward of the squared error sum((out - y)^2); returns it
+    Scalar train_sample(const Scalar* x, const Scalar* y) {
+        std::array<Scalar, nout> out, dout;
+        forward(x, out.data());
+        Scalar loss = 0.0;
+        for (int j = 0; j < nout; ++j) {
+            const Scalar e = out[j] - y[j];
+            loss += e * e;
+            dout[j] = 2.0 * e;
+        }
+        backward(dout.data());
+        return loss;
+    }
+
+    void zero_grad() {
+        grad.fill(0.0);
+    }
+
+    // data -= lr * grad
+    void sgd_step(Scalar lr) {
+        for (int i = 0; i < num_parameters; ++i) data[i] -= lr * grad[i];
+    }
+
+  private:
+    // Inputs of every layer plus the network output, from the last forward()
+    std::array<Scalar, activation_offset(num_layers + 1)> _act{};
+
+    static void check(const MLP& model) {
+        bool same = (int)model.layers.size() == num_layers;
+        for (int l = 0; same && l < num_layers; ++l) {
+            const Layer& layer = *model.layers[l];
+            same = (int)layer.neurons.size() == sizes[l + 1] && (int)layer.neurons[0]->w.size() == sizes[l] &&
+                   layer.neurons[0]->nonlin == (l + 1 < num_layers);
+        }
+        if (!same) {
+            std::string arch = std::to_string(nin);
+            for (int l = 1; l <= num_layers; ++l) arch += "," + std::to_string(sizes[l]);
+            throw std::runtime_error("StaticMLP<" + arch + ">: the MLP has a different architecture");
+        }
+    }
+
+    // out = act(W in + b) for layer L
+    template <int L>
+    void layer_forward(const Scalar* in, Scalar* out) const {
+        constexpr int NIN = sizes[L], NOUT = sizes[L + 1];
+        constexpr bool relu = L + 1 < num_layers;
+        const Scalar* p = data.data() + param_offset(L);
+        for (int j = 0; j < NOUT; ++j, p += NIN + 1) {
+            Scalar a = p[NIN];
+            for (int i = 0; i < NIN; ++i) a += p[i] * in[i];
+            out[j] = (relu && a < 0) ? 0.0 : a;
+        }
+    }
+
+    // Layer L: grads from dout and the saved activations; dx only below the first layer
+    template <int L>
+    void layer_backward(const Scalar* dout, Scalar* dx) {
+        constexpr int NIN = sizes[L], NOUT = sizes[L + 1];
+        constexpr bool relu = L + 1 < num_layers;
+        const Scalar* in = _act.data() + activation_offset(L);
+        const Scalar* out = _act.data() + activation_offset(L + 1);
+        const Scalar* p = data.data() + param_offset(L);
+        Scalar* g = grad.data() + param_offset(L);
+
+        if (L > 0) std::fill(dx, dx + NIN, 0.0);
+        for (int j = 0; j < NOUT; ++j, p += NIN + 1, g += NIN + 1) {
+            const Scalar d = (relu && out[j] <= 0) ? 0.0 : dout[j];
+            g[NIN] += d;
+            for (int i = 0; i < NIN; ++i) {
+                g[i] += d * in[i];
+                if (L > 0) dx[i] += d * p[i];
+            }
+        }
+    }
+
+    // Layer L reads buf[L % 2] (x for L = 0) and writes buf[(L + 1) % 2] (out for the last)
+    template <int... L>
+    void predict_layers(const Scalar* x, Scalar* out, std::array<Scalar, max_width()>* buf,
+                        std::integer_sequence<int, L...>) const {
+        (layer_forward<L>(L == 0 ? x : buf[L % 2].data(), L + 1 == num_layers ? out : buf[(L + 1) % 2].data()), ...);
+    }
+
+    template <int... L>
+    void forward_layers(std::integer_sequence<int, L...>) {
+        (layer_forward<L>(_act.data() + activation_offset(L), _act.data() + activation_offset(L + 1)), ...);
+    }
+
+    // Last layer first: layer K reads its dout from buf[(K + 1) % 2] and writes dx to buf[K % 2]
+    template <int... L>
+    void backward_layers(std::array<Scalar, max_width()>* buf, std::integer_sequence<int, L...>) {
+        (layer_backward<num_layers - 1 - L>(buf[(num_layers - L) % 2].data(), buf[(num_layers - 1 - L) % 2].data()), ...);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Tape.h"
+#include <cmath>
+#include <stdexcept>
+
+// --------------------------------------------------------------------------
+// TAPE
+// --------------------------------------------------------------------------
+
+Tape::Tape(size_t reserve) {
+    nodes.reserve(reserve);
+}
+
+Var Tape::push(Op op, Scalar data, int32_t lhs, int32_t rhs) {
+    if (op == Op::DotBiasAct) {
+        // Needs n operands; a tape node has at most two children
+        throw std::runtime_error("tape: Op::DotBiasAct is Value-only");
+    }
+    nodes.push_back(TapeNode{ data, 0.0, lhs, rhs, op });
+    return Var{ this, static_cast<int32_t>(nodes.size() - 1) };
+}
+
+Var Tape::leaf(Scalar data) {
+    return push(Op::Leaf, data);
+}
+
+std::vector<Var> Tape::leaves(const std::vector<Scalar>& data) {
+    std::vector<Var> out;
+    out.reserve(data.size());
+    for (Scalar d : data) {
+        out.push_back(leaf(d));
+    }
+    return out;
+}
+
+Var Tape::param(const std::shared_ptr<Value>& v) {
+    Var out = leaf(v->data);
+    bindings.emplace_back(out.index, v.get());
+    return out;
+}
+
+void Tape::propagate(Var root) {
+    TapeNode* n = nodes.data();
+
+    // Start from clean node grads, so propagating the same tape twice gives
+    // the same result (like Value::backward, which clears intermediates)
+    for (int32_t i = 0; i < root.index; ++i) {
+        n[i].grad = 0.0;
+    }
+    n[root.index].grad = 1.0;
+
+    // Children always sit before their parents, so walking backwards from
+    // the root visits every node after all of its consumers.
+    for (int32_t i = root.index; i >= 0; --i) {
+        const TapeNode& out = n[i];
+        switch (out.op) {
+        case Op::Leaf:
+            break;
+        case Op::Add:
+            n[out.lhs].grad += out.grad;
+            n[out.rhs].grad += out.grad;
+            break;
+        case Op::Mul:
+            n[out.lhs].grad += n[out.rhs].data * out.grad;
+            n[out.rhs].grad += n[out.lhs].data * out.grad;
+            break;
+        case Op::Pow: {
+            Scalar exponent = n[out.rhs].data;
+            n[out.lhs].grad += (exponent * std::pow(n[out.lhs].data, exponent - 1.0)) * out.grad;
+            break;
+        }
+        case Op::ReLU:
+            n[out.lhs].grad += (out.data > 0 ? 1.0 : 0.0) * out.grad;
+            break;
+        case Op::Tanh:
+            n[out.lhs].grad += (1.0 - out.data * out.data) * out.grad;
+            break;
+        case Op::Exp:
+            n[out.lhs].grad += out.data * out.grad;
+            break;
+        case Op::DotBiasAct:
+            break; // rejected by push()
+        }
+    }
+}
+
+void Tape::flush() {
+    for (const auto& b : bindings) {
+        b.second->grad += nodes[b.first].grad;
+    }
+}
+
+void Tape::backward(Var root) {
+    propagate(root);
+    flush();
+}
+
+void Tape::reset() {
+    // TapeNode is trivially destructible, so clear() just moves the end pointer
+    nodes.clear();
+    bindings.clear();
+}
+
+// --------------------------------------------------------------------------
+// VAR
+// --------------------------------------------------------------------------
+
+Scalar Var::data() const { return tape->nodes[index].data; }
+Scalar Var::grad() const { return tape->nodes[index].grad; }
+
+Var Var::add(Var rhs) const {
+    return tape->push(Op::Add, data() + rhs.data(), index, rhs.index);
+}
+
+Var Var::mul(Var rhs) const {
+    return tape->push(Op::Mul, data() * rhs.data(), index, rhs.index);
+}
+
+Var Var::pow(Scalar exponent) const {
+    Var e = tape->leaf(exponent);
+    return tape->push(Op::Pow, std::pow(data(), exponent), index, e.index);
+}
+
+Var Var::relu() const {
+    Scalar x = data();
+    return tape->push(Op::ReLU, x < 0 ? 0.0 : x, index);
+}
+
+Var Var::tanh() const {
+    return tape->push(Op::Tanh, std::tanh(data()), index);
+}
+
+Var Var::exp() const {
+    return tape->push(Op::Exp, std::exp(data()), index);
+}
+
+Var Var::add(Scalar rhs) const { return add(tape->leaf(rhs)); }
+Var Var::mul(Scalar rhs) const { return mul(tape->leaf(rhs)); }
+
+void Var::backward() const {
+    tape->backward(*this);
+}
+
+// Addition
+Var operator+(Var lhs, Var rhs) { return lhs.add(rhs); }
+Var operator+(Var lhs, Scalar rhs) { return lhs.add(rhs); }
+Var operator+(Scalar lhs, Var rhs) { return rhs.add(lhs); }
+
+// Multiplication
+Var operator*(Var lhs, Var rhs) { return lhs.mul(rhs); }
+Var operator*(Var lhs, Scalar rhs) { return lhs.mul(rhs); }
+Var operator*(Scalar lhs, Var rhs) { return rhs.mul(lhs); }
+
+// Negation & Subtraction
+Var operator-(Var rhs) { return rhs.mul(-1.0); }
+Var operator-(Var lhs, Var rhs) { return lhs.add(rhs.mul(-1.0)); }
+
+// Division
+Var operator/(Var lhs, Var rhs) { return lhs.mul(rhs.pow(-1.0)); }
+
+// Print
+std::ostream& operator<<(std::ostream& os, const Var& v) {
+    os << "Var(data=" << v.data() << ", grad=" << v.grad() << ")";
+    return os;
+}
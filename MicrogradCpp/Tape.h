@@ -0,0 +1,112 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Op.h"
+#include "Value.h"
+
+// --------------------------------------------------------------------------
+// TAPE (ARENA) ENGINE
+// --------------------------------------------------------------------------
+// A Tape records one step's computation as a flat array of nodes.
+// Children are integer indices into the same array, so there are no
+// shared_ptrs, no _prev sets and no std::function closures per node.
+//
+// Nodes are only ever appended after their children, so the array is
+// already in topological order: backward() is a single reverse sweep.
+//
+// The tape is a separate API next to Value rather than an allocator
+// under it: shared_ptr<Value> graphs still allocate per node, and code
+// that wants the arena records Vars instead (Neuron, Layer and MLP have
+// tape overloads of operator()).
+//
+// Parameters stay ordinary Values. param() copies a Value into the tape
+// as a leaf, and backward() adds the leaf's gradient back into Value::grad,
+// so Module::zero_grad() and the usual `p->data -= lr * p->grad` update
+// keep working unchanged.
+//
+// Typical step:
+//     tape.reset();                     // O(1), keeps the allocation
+//     Var loss = ...;                   // build with model(tape, x)
+//     tape.backward(loss);              // fills Value::grad of the parameters
+
+struct TapeNode {
+    Scalar data;
+    Scalar grad;
+    int32_t lhs; // first child (-1 if none)
+    int32_t rhs; // second child (-1 if none). For Pow: a constant leaf holding the exponent
+    Op op;
+};
+
+struct Tape;
+
+// Handle to a node on a Tape. Mirrors the Value API.
+struct Var {
+    Tape* tape;
+    int32_t index;
+
+    Scalar data() const;
+    Scalar grad() const;
+
+    // Core Operations
+    Var add(Var rhs) const;
+    Var mul(Var rhs) const;
+    Var pow(Scalar exponent) const;
+
+    // Activations & Non-linearities
+    Var relu() const;
+    Var tanh() const;
+    Var exp() const;
+
+    // Convenience Wrappers
+    Var add(Scalar rhs) const;
+    Var mul(Scalar rhs) const;
+
+    // Engine
+    void backward() const;
+
+    // Friend Operators
+    friend Var operator+(Var lhs, Var rhs);
+    friend Var operator+(Var lhs, Scalar rhs);
+    friend Var operator+(Scalar lhs, Var rhs);
+
+    friend Var operator*(Var lhs, Var rhs);
+    friend Var operator*(Var lhs, Scalar rhs);
+    friend Var operator*(Scalar lhs, Var rhs);
+
+    friend Var operator-(Var rhs);
+    friend Var operator-(Var lhs, Var rhs);
+    friend Var operator/(Var lhs, Var rhs);
+
+    friend std::ostream& operator<<(std::ostream& os, const Var& v);
+};
+
+struct Tape {
+    std::vector<TapeNode> nodes;
+
+    // Leaves created by param(): (node index, parameter it was copied from)
+    std::vector<std::pair<int32_t, Value*>> bindings;
+
+    // reserve = expected node count per step (avoids regrowth on the first step)
+    explicit Tape(size_t reserve = 0);
+
+    // Leaves
+    Var leaf(Scalar data);                           // input / constant
+    std::vector<Var> leaves(const std::vector<Scalar>& data);
+    Var param(const std::shared_ptr<Value>& v);      // gradient flows back into v->grad
+
+    // Append a node. Children must already be on the tape.
+    // Throws std::runtime_error for Op::DotBiasAct (Value-only).
+    Var push(Op op, Scalar data, int32_t lhs = -1, int32_t rhs = -1);
+
+    // Engine
+    void propagate(Var root); // fill node grads only (every node up to root restarts from 0)
+    void flush();             // add bound leaf grads into their Value::grad
+    void backward(Var root);  // propagate + flush
+
+    // Drop every node in O(1). Capacity is kept for the next step.
+    void reset();
+
+    size_t size() const { return nodes.size(); }
+};
@@ -0,0 +1,412 @@
+#include "Tensor.h"
+#include "Kernels.h"
+#include "Profile.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+
+// Constructor
+Tensor::Tensor(int rows, int cols, std::vector<std::shared_ptr<Tensor>> children, std::string _op)
+    : rows(rows), cols(cols), data((size_t)rows * cols, 0.0), grad((size_t)rows * cols, 0.0),
+      _prev(std::move(children)), op(_op), _backward([]() {})
+{
+}
+
+// --------------------------------------------------------------------------
+// FACTORIES
+// --------------------------------------------------------------------------
+
+std::shared_ptr<Tensor> Tensor::zeros(int rows, int cols) {
+    return std::make_shared<Tensor>(rows, cols);
+}
+
+std::shared_ptr<Tensor> Tensor::from_data(int rows, int cols, std::vector<Scalar> data) {
+    assert(data.size() == (size_t)rows * cols);
+    auto out = std::make_shared<Tensor>(rows, cols);
+    out->data = std::move(data);
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::from_rows(const std::vector<std::vector<Scalar>>& rows) {
+    int r = (int)rows.size();
+    int c = r > 0 ? (int)rows[0].size() : 0;
+    auto out = std::make_shared<Tensor>(r, c);
+    for (int i = 0; i < r; ++i) {
+        // We assume every row has the same length
+        std::copy(rows[i].begin(), rows[i].end(), out->data.begin() + (size_t)i * c);
+    }
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::from_values(const std::vector<Value*>& src, int rows, int cols,
+                                            std::vector<Scalar*> grad_dst) {
+    assert(src.size() == (size_t)rows * cols);
+    assert(grad_dst.empty() || grad_dst.size() == src.size());
+    auto out = std::make_shared<Tensor>(rows, cols, std::vector<std::shared_ptr<Tensor>>{}, "values");
+    for (size_t i = 0; i < src.size(); ++i) {
+        out->data[i] = src[i]->data;
+    }
+    if (grad_dst.empty()) {
+        grad_dst.reserve(src.size());
+        for (Value* v : src) {
+            grad_dst.push_back(&v->grad);
+        }
+    }
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [grad_dst, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            for (size_t i = 0; i < grad_dst.size(); ++i) {
+                *grad_dst[i] += out_ptr->grad[i];
+            }
+        }
+        };
+    return out;
+}
+
+// --------------------------------------------------------------------------
+// CORE MATH
+// --------------------------------------------------------------------------
+
+std::shared_ptr<Tensor> Tensor::matmul(std::shared_ptr<Tensor> rhs) {
+    auto lhs = shared_from_this();
+    assert(lhs->cols == rhs->rows);
+    int M = lhs->rows, K = lhs->cols, N = rhs->cols;
+
+    auto out = std::make_shared<Tensor>(M, N, std::vector<std::shared_ptr<Tensor>>{ lhs, rhs }, "@");
+    kernels::gemm_nn(M, N, K, lhs->data.data(), rhs->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [lhs, rhs, M, N, K, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            // dL/dlhs = dL/dout * rhs^T,  dL/drhs = lhs^T * dL/dout
+            kernels::gemm_nt(M, K, N, out_ptr->grad.data(), rhs->data.data(), lhs->grad.data());
+            kernels::gemm_tn(K, N, M, lhs->data.data(), out_ptr->grad.data(), rhs->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::add_bias(std::shared_ptr<Tensor> bias) {
+    auto self = shared_from_this();
+    assert(bias->rows == 1 && bias->cols == self->cols);
+    int M = self->rows, N = self->cols;
+
+    auto out = std::make_shared<Tensor>(M, N, std::vector<std::shared_ptr<Tensor>>{ self, bias }, "+b");
+    out->data = self->data;
+    kernels::add_rows(M, N, bias->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, bias, M, N, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            kernels::axpy((int)out_ptr->size(), 1.0, out_ptr->grad.data(), self->grad.data());
+            kernels::sum_rows(M, N, out_ptr->grad.data(), bias->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::add(std::shared_ptr<Tensor> rhs) {
+    auto lhs = shared_from_this();
+    assert(lhs->rows == rhs->rows && lhs->cols == rhs->cols);
+
+    auto out = std::make_shared<Tensor>(lhs->rows, lhs->cols, std::vector<std::shared_ptr<Tensor>>{ lhs, rhs }, "+");
+    out->data = lhs->data;
+    kernels::axpy((int)out->size(), 1.0, rhs->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [lhs, rhs, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            int n = (int)out_ptr->size();
+            kernels::axpy(n, 1.0, out_ptr->grad.data(), lhs->grad.data());
+            kernels::axpy(n, 1.0, out_ptr->grad.data(), rhs->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::mul(std::shared_ptr<Tensor> rhs) {
+    auto lhs = shared_from_this();
+    assert(lhs->rows == rhs->rows && lhs->cols == rhs->cols);
+
+    auto out = std::make_shared<Tensor>(lhs->rows, lhs->cols, std::vector<std::shared_ptr<Tensor>>{ lhs, rhs }, "*");
+    kernels::mul_acc((int)out->size(), lhs->data.data(), rhs->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [lhs, rhs, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            int n = (int)out_ptr->size();
+            kernels::mul_acc(n, rhs->data.data(), out_ptr->grad.data(), lhs->grad.data());
+            kernels::mul_acc(n, lhs->data.data(), out_ptr->grad.data(), rhs->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::sub(std::shared_ptr<Tensor> rhs) {
+    auto lhs = shared_from_this();
+    assert(lhs->rows == rhs->rows && lhs->cols == rhs->cols);
+
+    auto out = std::make_shared<Tensor>(lhs->rows, lhs->cols, std::vector<std::shared_ptr<Tensor>>{ lhs, rhs }, "-");
+    out->data = lhs->data;
+    kernels::axpy((int)out->size(), -1.0, rhs->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [lhs, rhs, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            int n = (int)out_ptr->size();
+            kernels::axpy(n, 1.0, out_ptr->grad.data(), lhs->grad.data());
+            kernels::axpy(n, -1.0, out_ptr->grad.data(), rhs->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::pow(Scalar exponent) {
+    auto self = shared_from_this();
+    auto out = std::make_shared<Tensor>(self->rows, self->cols, std::vector<std::shared_ptr<Tensor>>{ self }, "**");
+    out->_aux = exponent;
+    for (size_t i = 0; i < out->size(); ++i) {
+        out->data[i] = std::pow(self->data[i], exponent);
+    }
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            const Scalar exponent = out_ptr->_aux;
+            for (size_t i = 0; i < out_ptr->size(); ++i) {
+                self->grad[i] += (exponent * std::pow(self->data[i], exponent - 1.0)) * out_ptr->grad[i];
+            }
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::sum() {
+    auto self = shared_from_this();
+    auto out = std::make_shared<Tensor>(1, 1, std::vector<std::shared_ptr<Tensor>>{ self }, "sum");
+    for (Scalar d : self->data) {
+        out->data[0] += d;
+    }
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            Scalar g = out_ptr->grad[0];
+            for (Scalar& sg : self->grad) {
+                sg += g;
+            }
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::linear(const Scalar* params, Scalar* grads, int nout) {
+    auto self = shared_from_this();
+    const int M = self->rows, K = self->cols, ld = K + 1;
+
+    auto out = std::make_shared<Tensor>(M, nout, std::vector<std::shared_ptr<Tensor>>{ self }, "linear");
+    std::vector<Scalar> bias(nout);
+    for (int j = 0; j < nout; ++j) {
+        bias[j] = params[(size_t)j * ld + K];
+    }
+    kernels::add_rows(M, nout, bias.data(), out->data.data());
+    kernels::gemm_nt(M, nout, K, self->data.data(), params, out->data.data(), ld);
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, params, grads, M, K, nout, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            const int ld = K + 1;
+            const Scalar* gy = out_ptr->grad.data();
+            // dL/dx = dL/dout * W,  dL/dW = dL/dout^T * x,  dL/db = column sums of dL/dout
+            kernels::gemm_nn(M, K, nout, gy, params, self->grad.data(), ld, 0);
+            kernels::gemm_tn(nout, K, M, gy, self->data.data(), grads, 0, ld);
+            std::vector<Scalar> gb(nout, 0.0);
+            kernels::sum_rows(M, nout, gy, gb.data());
+            for (int j = 0; j < nout; ++j) {
+                grads[(size_t)j * ld + K] += gb[j];
+            }
+        }
+        };
+    return out;
+}
+
+// --------------------------------------------------------------------------
+// ACTIVATIONS
+// --------------------------------------------------------------------------
+
+std::shared_ptr<Tensor> Tensor::relu() {
+    auto self = shared_from_this();
+    auto out = std::make_shared<Tensor>(self->rows, self->cols, std::vector<std::shared_ptr<Tensor>>{ self }, "ReLU");
+    kernels::relu((int)out->size(), self->data.data(), out->data.data());
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            kernels::relu_backward((int)out_ptr->size(), out_ptr->data.data(), out_ptr->grad.data(), self->grad.data());
+        }
+        };
+    return out;
+}
+
+std::shared_ptr<Tensor> Tensor::tanh() {
+    auto self = shared_from_this();
+    auto out = std::make_shared<Tensor>(self->rows, self->cols, std::vector<std::shared_ptr<Tensor>>{ self }, "tanh");
+    for (size_t i = 0; i < out->size(); ++i) {
+        out->data[i] = std::tanh(self->data[i]);
+    }
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            kernels::tanh_backward((int)out_ptr->size(), out_ptr->data.data(), out_ptr->grad.data(), self->grad.data());
+        }
+        };
+    return out;
+}
+
+// --------------------------------------------------------------------------
+// CHECKPOINTING
+// --------------------------------------------------------------------------
+
+std::shared_ptr<Tensor> Tensor::checkpoint(Segment segment) {
+    return checkpoint(std::vector<Segment>{ std::move(segment) });
+}
+
+// Inputs of segments 1 .. n-1 of a checkpointed chain, in one of two formats
+struct SavedBoundaries {
+    std::vector<int> rows, cols;           // input shape of every segment
+    std::vector<std::vector<Scalar>> full; // [s], empty when bf16
+    std::vector<std::vector<bf16>> half;   // [s], empty when not bf16
+};
+
+std::shared_ptr<Tensor> Tensor::checkpoint(std::vector<Segment> segments, bool bf16_boundaries) {
+    auto self = shared_from_this();
+    const size_t n = segments.size();
+    auto saved = std::make_shared<SavedBoundaries>();
+    saved->full.resize(n);
+    saved->half.resize(n);
+
+    // Each segment's graph hangs off a detached input and is released as
+    // soon as its output data has been taken
+    int r = self->rows, c = self->cols;
+    std::vector<Scalar> cur = self->data;
+    for (size_t s = 0; s < n; ++s) {
+        if (s > 0 && bf16_boundaries) {
+            saved->half[s].resize(cur.size());
+            kernels::to_bf16((int)cur.size(), cur.data(), saved->half[s].data());
+            kernels::from_bf16((int)cur.size(), saved->half[s].data(), cur.data());
+        }
+        saved->rows.push_back(r);
+        saved->cols.push_back(c);
+
+        auto in = Tensor::from_data(r, c, std::move(cur));
+        auto inner = segments[s](in);
+        if (s > 0 && !bf16_boundaries) saved->full[s] = std::move(in->data);
+        r = inner->rows;
+        c = inner->cols;
+        cur = std::move(inner->data);
+    }
+
+    auto out = std::make_shared<Tensor>(r, c, std::vector<std::shared_ptr<Tensor>>{ self }, "checkpoint");
+    out->data = std::move(cur);
+
+    std::weak_ptr<Tensor> weak_out = out;
+    out->_backward = [self, segments, saved, n, weak_out]() {
+        auto out_ptr = weak_out.lock();
+        if (out_ptr) {
+            // Recompute each segment, then backpropagate dL/d(its output)
+            // through the rebuilt graph; the segment's own leaves (e.g.
+            // parameters) get their grads there
+            std::vector<Scalar> g = out_ptr->grad;
+            for (size_t s = n; s-- > 0;) {
+                std::vector<Scalar> x;
+                if (s == 0) x = self->data;
+                else if (!saved->half[s].empty()) {
+                    x.resize(saved->half[s].size());
+                    kernels::from_bf16((int)x.size(), saved->half[s].data(), x.data());
+                }
+                else x = saved->full[s];
+
+                auto in = Tensor::from_data(saved->rows[s], saved->cols[s], std::move(x));
+                segments[s](in)->backward(g.data());
+                g = std::move(in->grad);
+            }
+            kernels::axpy((int)self->size(), 1.0, g.data(), self->grad.data());
+        }
+        };
+    return out;
+}
+
+// --------------------------------------------------------------------------
+// ENGINE
+// --------------------------------------------------------------------------
+
+// Atomic so graphs built on different threads never share an epoch
+static std::atomic<uint32_t> tensor_topo_epoch{ 0 };
+
+void Tensor::build_topo(std::vector<Tensor*>& topo) {
+    const uint32_t epoch = ++tensor_topo_epoch;
+    topo.clear();
+
+    std::vector<std::pair<Tensor*, size_t>> stack;
+    stack.emplace_back(this, 0);
+    _visited = epoch;
+
+    while (!stack.empty()) {
+        Tensor* t = stack.back().first;
+        size_t& next = stack.back().second;
+        if (next < t->_prev.size()) {
+            Tensor* child = t->_prev[next++].get();
+            if (child->_visited != epoch) {
+                child->_visited = epoch;
+                stack.emplace_back(child, 0);
+            }
+        }
+        else {
+            topo.push_back(t);
+            stack.pop_back();
+        }
+    }
+}
+
+void Tensor::backward() {
+    std::vector<Scalar> ones(size(), 1.0);
+    backward(ones.data());
+}
+
+void Tensor::backward(const Scalar* seed) {
+    std::vector<Tensor*> topo;
+    {
+        MG_PROFILE_SCOPE("Tensor.backward.topo");
+        build_topo(topo);
+    }
+
+    MG_PROFILE_SCOPE("Tensor.backward.propagate");
+    for (Tensor* t : topo) {
+        if (!t->_prev.empty()) std::fill(t->grad.begin(), t->grad.end(), 0.0);
+    }
+    std::copy(seed, seed + size(), grad.begin());
+
+    for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+        (*it)->_backward();
+    }
+}
+
+// Print
+std::ostream& operator<<(std::ostream& os, const std::shared_ptr<Tensor>& t) {
+    os << "Tensor(" << t->rows << "x" << t->cols << ", op=\"" << t->op << "\")";
+    return os;
+}
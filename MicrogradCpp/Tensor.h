@@ -0,0 +1,99 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "Value.h"
+
+// --------------------------------------------------------------------------
+// TENSOR
+// --------------------------------------------------------------------------
+// A rows x cols row-major matrix that is a single node of the autograd
+// graph, with its own gradient buffer of the same shape.
+//
+// Where the Value path builds one node per scalar multiply/add, a Tensor
+// op covers a whole layer: x->matmul(W)->add_bias(b)->relu() is three nodes
+// however wide the layer is. Forward and backward passes run the blocked
+// SIMD kernels in Kernels.h.
+
+struct Tensor : public std::enable_shared_from_this<Tensor> {
+    int rows;
+    int cols;
+    std::vector<Scalar> data; // rows * cols, row-major
+    std::vector<Scalar> grad; // same shape as data
+    std::vector<std::shared_ptr<Tensor>> _prev;
+    std::string op;
+    Scalar _aux = 0.0; // pow: the exponent
+    std::function<void()> _backward;
+
+    uint32_t _visited = 0; // epoch of the last topological sort that reached this node
+
+    Tensor(int rows, int cols, std::vector<std::shared_ptr<Tensor>> children = {}, std::string _op = "");
+
+    // Factories
+    static std::shared_ptr<Tensor> zeros(int rows, int cols);
+    static std::shared_ptr<Tensor> from_data(int rows, int cols, std::vector<Scalar> data);
+    static std::shared_ptr<Tensor> from_rows(const std::vector<std::vector<Scalar>>& rows); // one sample per row
+
+    // Leaf holding a copy of some Values' data (src[i] -> element i).
+    // Its gradient is added back into src[i]->grad during backward(),
+    // which is how Layer's parameters take part in a tensor graph.
+    // If grad_dst is given, element i's gradient goes to *grad_dst[i]
+    // instead (e.g. a per-thread buffer), and the Values are not touched.
+    static std::shared_ptr<Tensor> from_values(const std::vector<Value*>& src, int rows, int cols,
+                                               std::vector<Scalar*> grad_dst = {});
+
+    size_t size() const { return data.size(); }
+    Scalar& at(int r, int c) { return data[(size_t)r * cols + c]; }
+
+    // Core Operations
+    std::shared_ptr<Tensor> matmul(std::shared_ptr<Tensor> rhs);    // (rows x k) * (k x n)
+    std::shared_ptr<Tensor> add_bias(std::shared_ptr<Tensor> bias); // bias is 1 x cols, added to every row
+    std::shared_ptr<Tensor> add(std::shared_ptr<Tensor> rhs);       // elementwise, same shape
+    std::shared_ptr<Tensor> mul(std::shared_ptr<Tensor> rhs);       // elementwise, same shape
+    std::shared_ptr<Tensor> sub(std::shared_ptr<Tensor> rhs);       // elementwise, same shape
+    std::shared_ptr<Tensor> pow(Scalar exponent);                   // elementwise
+    std::shared_ptr<Tensor> sum();                                  // 1 x 1, sum of every element
+
+    // Affine map reading its parameters in place: out (rows x nout) = this * W^T + b.
+    // params holds nout rows of (cols + 1) Scalars, each a neuron's weights
+    // followed by its bias (i.e. a Layer's slice of ParameterStore).
+    // backward() adds the parameter gradients into grads, same layout.
+    // Both buffers must outlive the graph.
+    std::shared_ptr<Tensor> linear(const Scalar* params, Scalar* grads, int nout);
+
+    // Activations & Non-linearities
+    std::shared_ptr<Tensor> relu();
+    std::shared_ptr<Tensor> tanh();
+
+    // Gradient checkpointing: out = segment(this), without keeping the graph
+    // segment() builds. The forward pass runs it on a detached copy of this
+    // tensor, keeps only the output's data and frees everything in between;
+    // backward() runs it again from the saved input and backpropagates
+    // through the fresh graph. Costs one extra forward of the segment, saves
+    // all of its intermediate activations. segment must be deterministic.
+    using Segment = std::function<std::shared_ptr<Tensor>(const std::shared_ptr<Tensor>&)>;
+    std::shared_ptr<Tensor> checkpoint(Segment segment);
+
+    // The same over a chain, out = segments[n-1](... segments[0](this)), as
+    // one node: the inputs of segments 1 .. n-1 are kept as plain buffers
+    // (no grad, no graph) and backward() recomputes the segments last to
+    // first. With bf16_boundaries those inputs are stored as bf16 and the
+    // forward pass uses the same rounded values, so the recomputation
+    // matches it exactly (mixed precision: Scalar math and parameters,
+    // low-precision saved activations).
+    std::shared_ptr<Tensor> checkpoint(std::vector<Segment> segments, bool bf16_boundaries = false);
+
+    // Engine
+    // Seeds this node's grad with ones, i.e. differentiates the sum of its
+    // elements (for a 1 x 1 loss that is just dloss/dloss = 1).
+    void build_topo(std::vector<Tensor*>& topo);
+    void backward();
+
+    // Same, seeding this node's grad with seed[0 .. size()) instead of ones
+    void backward(const Scalar* seed);
+
+    friend std::ostream& operator<<(std::ostream& os, const std::shared_ptr<Tensor>& t);
+};
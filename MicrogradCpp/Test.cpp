@@ -1,33 +1,38 @@
-#include "test.h"
+#include "Test.h"
 #include "Value.h"
 #include "MLP.h"
-
-// Helper function to create Value objects
-std::shared_ptr<Value> v(double val) {
-    return std::make_shared<Value>(val);
-}
+#include "Tensor.h"
+#include "Optimizer.h"
+#include "Profile.h"
+#include "Trainer.h"
+#include <algorithm>
+#include <chrono>
 
 Test::Test()
 {
     // -----------------------------------------------------------------------
        // 1. SETUP THE DATASET
        // -----------------------------------------------------------------------
-       // The inputs (xs)
-    std::vector<std::vector<std::shared_ptr<Value>>> xs = {
-        {v(2.0), v(3.0), v(-1.0)},
-        {v(3.0), v(-1.0), v(0.5)},
-        {v(0.5), v(1.0), v(1.0)},
-        {v(1.0), v(1.0), v(-1.0)}
+       // The inputs (xs), one sample per row
+    std::vector<std::vector<Scalar>> xs = {
+        {2.0, 3.0, -1.0},
+        {3.0, -1.0, 0.5},
+        {0.5, 1.0, 1.0},
+        {1.0, 1.0, -1.0}
     };
 
     // The desired targets (ys)
-    std::vector<std::shared_ptr<Value>> ys = {
-        v(1.0),
-        v(-1.0),
-        v(-1.0),
-        v(1.0)
+    std::vector<std::vector<Scalar>> ys = {
+        {1.0},
+        {-1.0},
+        {-1.0},
+        {1.0}
     };
 
+    // The whole dataset as one batch: X is (4 x 3), Y is (4 x 1)
+    auto X = Tensor::from_rows(xs);
+    auto Y = Tensor::from_rows(ys);
+
     // -----------------------------------------------------------------------
     // 2. INITIALIZE THE NEURAL NETWORK
     // -----------------------------------------------------------------------
@@ -39,6 +44,12 @@ Test::Test()
 
     std::cout << "Model Architecture: " << model << "\n\n";
 
+    // A second model starting from the same weights, for the asynchronous
+    // run in section 5
+    MLP async_model(3, { 4, 4, 1 });
+    const ParameterSpan initial = model.parameter_span();
+    std::copy(initial.data, initial.data + initial.size, async_model.parameter_span().data);
+
     // -----------------------------------------------------------------------
     // 3. TRAINING LOOP
     // -----------------------------------------------------------------------
@@ -46,45 +57,41 @@ Test::Test()
     int steps = 20;
     double learning_rate = 0.05; // Slightly conservative rate
 
+    // Plain gradient descent: data = data - learning_rate * gradient
+    SGD optimizer(model, learning_rate);
+
+    // Wall-clock time of the training steps (not the logging) and the mean
+    // loss per row after each one, to compare with section 5
+    TrainingLog sync_log;
+    double seconds = 0.0;
+
     for (int k = 0; k < steps; ++k) {
+        const auto start = std::chrono::steady_clock::now();
 
         // A. FORWARD PASS
-        std::vector<std::shared_ptr<Value>> ypred;
-        std::shared_ptr<Value> total_loss = v(0.0);
-
-        for (size_t i = 0; i < xs.size(); ++i) {
-            // Run the model on input x[i]
-            // The model returns a vector, but since output layer is size 1, 
-            // we take the first element [0].
-            auto output_vector = model(xs[i]);
-            auto prediction = output_vector[0];
-            ypred.push_back(prediction);
-
-            // Calculate Mean Squared Error Loss for this single example
-            // Loss = (prediction - target)^2
-            auto diff = prediction - ys[i];
-            auto loss = diff->pow(2);
-
-            // Accumulate total loss
-            total_loss = total_loss + loss;
-        }
+        // One batched pass over every sample: ypred is (4 x 1)
+        auto ypred = model(X);
+
+        // Sum of Squared Errors over the batch
+        // Loss = sum((prediction - target)^2)
+        auto total_loss = ypred->sub(Y)->pow(2)->sum();
 
         // B. ZERO GRADIENTS
         // Reset old gradients before calculating new ones!
-        model.zero_grad();
+        optimizer.zero_grad();
 
         // C. BACKWARD PASS
-        // Calculate gradients for every weight in the network
+        // One sweep accumulates every weight's gradient across the batch
         total_loss->backward();
 
         // D. UPDATE PARAMETERS (Gradient Descent)
-        // data = data - learning_rate * gradient
-        for (auto& p : model.parameters()) {
-            p->data -= learning_rate * p->grad;
-        }
+        optimizer.step();
 
         // E. LOGGING
-        std::cout << "Step " << k << " | Loss: " << total_loss->data << "\n";
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sync_log.seconds.push_back(seconds);
+        sync_log.loss.push_back(total_loss->data[0] / X->rows);
+        std::cout << "Step " << k << " | Loss: " << total_loss->data[0] << "\n";
     }
 
     // -----------------------------------------------------------------------
@@ -92,9 +99,31 @@ Test::Test()
     // -----------------------------------------------------------------------
     std::cout << "\nFinal Predictions:\n";
     for (size_t i = 0; i < xs.size(); ++i) {
-        // Run one last forward pass to see the result
-        auto pred = model(xs[i])[0];
-        std::cout << "Input " << i << " -> Target: " << ys[i]->data
-            << " | Prediction: " << pred->data << "\n";
+        // Inference only: no graph is needed to see the result
+        Scalar pred;
+        model.predict(xs[i].data(), &pred);
+        std::cout << "Input " << i << " -> Target: " << ys[i][0]
+            << " | Prediction: " << pred << "\n";
+    }
+
+    // -----------------------------------------------------------------------
+    // 5. ASYNCHRONOUS (HOGWILD) TRAINING
+    // -----------------------------------------------------------------------
+    // The same initial weights and number of passes over the data: 2 threads,
+    // one sample per update, no synchronization between them. Both logs
+    // hold the mean loss per row against the time spent training.
+    HogwildTrainer trainer(async_model, learning_rate, 2);
+    TrainingLog async_log = trainer.train(X, Y, steps);
+
+    std::cout << "\nConvergence vs wall-clock (mean loss per row)\n";
+    std::cout << "Synchronous loop (section 3):\n" << sync_log;
+    std::cout << "Hogwild, " << trainer.threads << " threads:\n" << async_log;
+
+    // -----------------------------------------------------------------------
+    // 6. PROFILE (only in builds with MICROGRAD_PROFILE)
+    // -----------------------------------------------------------------------
+    if (profiler::enabled()) {
+        std::cout << "\n";
+        profiler::print_summary(std::cout);
     }
 }
\ No newline at end of file
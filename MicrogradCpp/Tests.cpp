@@ -0,0 +1,349 @@
+#include "Graph.h"
+#include "Kernels.h"
+#include "MLP.h"
+#include "Sparse.h"
+#include "StaticMLP.h"
+#include "Tape.h"
+#include "Tensor.h"
+#include "ThreadPool.h"
+#include "Value.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------------------------
+// TESTS
+// --------------------------------------------------------------------------
+// Every fast path against the path it replaces, on random weights:
+//
+//     microgradcpp_tests              all checks
+//     microgradcpp_tests <name>       one check (ctest runs them one by one)
+//
+// Paths that only reorder floating-point additions must agree to within
+// TOLERANCE, relative to the largest reference value (at least 1).
+
+static const double TOLERANCE = sizeof(Scalar) == sizeof(float) ? 1e-3 : 1e-10;
+
+static std::mt19937 rng(1234);
+
+static std::vector<Scalar> random_values(size_t n) {
+    std::uniform_real_distribution<> dis(-1.0, 1.0);
+    std::vector<Scalar> v(n);
+    for (Scalar& x : v) x = (Scalar)dis(rng);
+    return v;
+}
+
+static std::vector<Scalar> grads(MLP& model) {
+    const ParameterSpan span = model.parameter_span();
+    return std::vector<Scalar>(span.grad, span.grad + span.size);
+}
+
+// Largest difference between got and want, relative to want's largest value
+static bool check(const char* what, const std::vector<Scalar>& got, const std::vector<Scalar>& want,
+                  double tolerance = TOLERANCE) {
+    double diff = got.size() == want.size() ? 0.0 : INFINITY;
+    double scale = 1.0;
+    for (size_t i = 0; i < got.size() && i < want.size(); ++i) {
+        diff = std::max(diff, (double)std::fabs(got[i] - want[i]));
+        scale = std::max(scale, (double)std::fabs(want[i]));
+    }
+    const bool ok = diff <= tolerance * scale;
+    std::printf("  %-52s %s (max diff %.3g)\n", what, ok ? "ok" : "FAILED", diff);
+    return ok;
+}
+
+// Sum of squared errors of model over rows of X against Y, as one Value graph
+static std::shared_ptr<Value> value_loss(MLP& model, const std::vector<std::vector<std::shared_ptr<Value>>>& xs,
+                                         const std::vector<Scalar>& Y) {
+    auto loss = std::make_shared<Value>(0.0);
+    const size_t nout = Y.size() / xs.size();
+    for (size_t r = 0; r < xs.size(); ++r) {
+        auto out = model(xs[r]);
+        for (size_t j = 0; j < nout; ++j) {
+            loss = loss + (out[j] - std::make_shared<Value>(Y[r * nout + j]))->pow(2);
+        }
+    }
+    return loss;
+}
+
+static std::vector<std::vector<std::shared_ptr<Value>>> value_rows(const std::vector<Scalar>& X, int rows) {
+    const size_t cols = X.size() / rows;
+    std::vector<std::vector<std::shared_ptr<Value>>> xs(rows);
+    for (int r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            xs[r].push_back(std::make_shared<Value>(X[r * cols + c]));
+        }
+    }
+    return xs;
+}
+
+// --------------------------------------------------------------------------
+// 1. Autograd engines
+// --------------------------------------------------------------------------
+
+static bool test_tensor_vs_value() {
+    MLP model(5, { 6, 6, 2 });
+    const int rows = 4;
+    const auto X = random_values(rows * 5), Y = random_values(rows * 2);
+
+    model.zero_grad();
+    value_loss(model, value_rows(X, rows), Y)->backward();
+    const auto want = grads(model);
+
+    model.zero_grad();
+    auto loss = model(Tensor::from_data(rows, 5, X))->sub(Tensor::from_data(rows, 2, Y))->pow(2)->sum();
+    loss->backward();
+    return check("Tensor batch gradients == Value graph", grads(model), want);
+}
+
+static bool test_checkpoint() {
+    MLP model(8, { 8, 8, 8, 8, 1 });
+    const int rows = 6;
+    auto X = Tensor::from_data(rows, 8, random_values(rows * 8));
+    auto Y = Tensor::from_data(rows, 1, random_values(rows));
+
+    auto run = [&](int every) {
+        model.checkpoint_every = every;
+        model.zero_grad();
+        model(X)->sub(Y)->pow(2)->sum()->backward();
+        return grads(model);
+    };
+    const auto want = run(0);
+    bool ok = check("checkpoint_every = 1 == plain", run(1), want);
+    ok &= check("checkpoint_every = 2 == plain", run(2), want);
+    model.checkpoint_every = 0;
+    return ok;
+}
+
+static bool test_parallel_backward() {
+    MLP model(64, { 64, 64, 1 });
+    const int rows = 4;
+    auto xs = value_rows(random_values(rows * 64), rows);
+    auto loss = value_loss(model, xs, random_values(rows));
+
+    auto all_grads = [&]() {
+        auto g = grads(model);
+        for (auto& x : xs) {
+            for (auto& v : x) g.push_back(v->grad);
+        }
+        return g;
+    };
+    auto zero = [&]() {
+        model.zero_grad();
+        for (auto& x : xs) {
+            for (auto& v : x) v->grad = 0.0;
+        }
+    };
+
+    zero();
+    loss->backward();
+    const auto want = all_grads();
+
+    bool ok = true;
+    for (int threads : { 1, 2, 4 }) {
+        ThreadPool pool(threads);
+        for (bool retain : { false, true }) {
+            zero();
+            loss->backward(pool, retain);
+            const std::string what = "parallel backward, " + std::to_string(threads) + " threads" +
+                                     (retain ? ", retained" : "") + " == serial";
+            ok &= check(what.c_str(), all_grads(), want);
+        }
+    }
+    return ok;
+}
+
+static bool test_captured_graph() {
+    MLP model(4, { 5, 5, 1 });
+    const int rows = 3;
+    auto X = random_values(rows * 4);
+    const auto Y = random_values(rows);
+    auto xs = value_rows(X, rows);
+    CapturedGraph graph(value_loss(model, xs, Y));
+
+    // New inputs and weights, then replay vs a graph built from scratch
+    X = random_values(rows * 4);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < 4; ++c) xs[r][c]->data = X[r * 4 + c];
+    }
+    const ParameterSpan span = model.parameter_span();
+    const auto noise = random_values(span.size);
+    for (size_t i = 0; i < span.size; ++i) span.data[i] += (Scalar)0.1 * noise[i];
+
+    model.zero_grad();
+    auto rebuilt = value_loss(model, value_rows(X, rows), Y);
+    rebuilt->backward();
+    const auto want = grads(model);
+
+    model.zero_grad();
+    const Scalar replayed = graph.forward();
+    graph.backward();
+    bool ok = check("captured forward == rebuilt graph", { replayed }, { rebuilt->data });
+    ok &= check("captured backward == rebuilt graph", grads(model), want);
+    return ok;
+}
+
+static bool test_tape() {
+    MLP model(3, { 4, 4, 1 });
+    const auto x = random_values(3);
+
+    model.zero_grad();
+    (model(value_rows(x, 1)[0])[0]->pow(2))->backward();
+    const auto want = grads(model);
+
+    // Twice over the same tape: node grads restart from zero each time
+    Tape tape;
+    Var loss = model(tape, tape.leaves(x))[0].pow(2);
+    bool ok = true;
+    for (int pass = 1; pass <= 2; ++pass) {
+        model.zero_grad();
+        tape.backward(loss);
+        ok &= check(pass == 1 ? "tape backward == Value graph" : "second tape backward == first", grads(model), want);
+    }
+    return ok;
+}
+
+// --------------------------------------------------------------------------
+// 2. Models
+// --------------------------------------------------------------------------
+
+static bool test_static_mlp() {
+    MLP model(3, { 4, 4, 1 });
+    StaticMLP<3, 4, 4, 1> fixed(model);
+    bool ok = true;
+
+    std::vector<Scalar> got, want;
+    for (int s = 0; s < 8; ++s) {
+        const auto x = random_values(3);
+        Scalar a, b;
+        fixed.predict(x.data(), &a);
+        model.predict(x.data(), &b);
+        got.push_back(a);
+        want.push_back(b);
+    }
+    ok &= check("StaticMLP predict == MLP predict", got, want);
+
+    const auto X = random_values(3), Y = random_values(1);
+    model.zero_grad();
+    model(Tensor::from_data(1, 3, X))->sub(Tensor::from_data(1, 1, Y))->pow(2)->sum()->backward();
+    fixed.zero_grad();
+    fixed.train_sample(X.data(), Y.data());
+    ok &= check("StaticMLP gradients == MLP gradients",
+                std::vector<Scalar>(fixed.grad.begin(), fixed.grad.end()), grads(model));
+    return ok;
+}
+
+static bool test_sparse_linear() {
+    const int nin = 40, nout = 4;
+    SparseBatch batch(nin);
+    const int32_t idx0[] = { 3, 17, 3, 39 }, idx1[] = { 0, 17, 25 };
+    const auto v0 = random_values(4), v1 = random_values(3);
+    batch.add_row(idx0, v0.data(), 4);
+    batch.add_row(idx1, v1.data(), 3);
+
+    // Central differences of sum(out^2). Without ReLU the loss is quadratic
+    // in every weight, so they are exact up to rounding; with it (double
+    // only) a step this small almost never crosses a kink.
+    auto run = [&](bool nonlin, double h, double tolerance) {
+        SparseLinear layer(nin, nout, nonlin);
+        auto loss = [&]() {
+            double sum = 0.0;
+            for (int r = 0; r < batch.rows(); ++r) {
+                Scalar out[nout];
+                const size_t k = batch.offsets[r];
+                layer.predict(batch.index.data() + k, batch.value.data() + k, (int)(batch.offsets[r + 1] - k), out);
+                for (Scalar o : out) sum += (double)o * o;
+            }
+            return sum;
+        };
+
+        layer.zero_grad();
+        layer(batch)->pow(2)->sum()->backward();
+
+        std::vector<Scalar> got, want;
+        for (int32_t row : { 0, 3, 17, 25, 39 }) {
+            for (int j = 0; j < nout; ++j) {
+                Scalar& w = layer.weight[(size_t)row * nout + j];
+                const Scalar w0 = w;
+                w = (Scalar)(w0 + h);
+                const double up = loss();
+                w = (Scalar)(w0 - h);
+                const double down = loss();
+                w = w0;
+                want.push_back((Scalar)((up - down) / (2 * h)));
+                got.push_back(layer.row_grad(row)[j]);
+            }
+        }
+        bool ok = check(nonlin ? "SparseLinear (ReLU) == finite differences" : "SparseLinear == finite differences",
+                        got, want, tolerance);
+        ok &= check("SparseLinear touches only the rows in the batch", { (Scalar)layer.touched_rows() }, { 5 });
+        ok &= check("SparseLinear untouched row has no gradient", { (Scalar)(layer.row_grad(1) == nullptr) }, { 1 });
+        return ok;
+    };
+
+    if (sizeof(Scalar) == sizeof(float)) {
+        return run(false, 1e-2, 1e-3);
+    }
+    bool ok = run(false, 1e-6, 1e-6);
+    ok &= run(true, 1e-6, 1e-6);
+    return ok;
+}
+
+// --------------------------------------------------------------------------
+// 3. Kernels
+// --------------------------------------------------------------------------
+
+static bool test_dot_u8s8() {
+    std::uniform_int_distribution<int> u8(0, 255), s8(-128, 127);
+    std::vector<Scalar> got, want;
+    // Every tail length around the 32 / 64-byte vector widths, plus the extremes
+    for (int n = 0; n <= 200; ++n) {
+        std::vector<uint8_t> x(n);
+        std::vector<int8_t> w(n);
+        int64_t reference = 0;
+        for (int i = 0; i < n; ++i) {
+            x[i] = (uint8_t)(n == 200 ? 255 : u8(rng));
+            w[i] = (int8_t)(n == 200 ? -128 : s8(rng));
+            reference += (int64_t)x[i] * w[i];
+        }
+        got.push_back((Scalar)kernels::dot_u8s8(n, x.data(), w.data()));
+        want.push_back((Scalar)reference);
+    }
+    const std::string what = std::string("dot_u8s8 (") + kernels::isa_int8() + ") == scalar reference";
+    return check(what.c_str(), got, want, 0.0);
+}
+
+// --------------------------------------------------------------------------
+// RUNNER
+// --------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    const std::vector<std::pair<const char*, std::function<bool()>>> tests = {
+        { "tensor_vs_value", test_tensor_vs_value },
+        { "checkpoint", test_checkpoint },
+        { "parallel_backward", test_parallel_backward },
+        { "captured_graph", test_captured_graph },
+        { "tape", test_tape },
+        { "static_mlp", test_static_mlp },
+        { "sparse_linear", test_sparse_linear },
+        { "dot_u8s8", test_dot_u8s8 },
+    };
+
+    int failed = 0, run = 0;
+    for (auto& t : tests) {
+        if (argc > 1 && std::strcmp(argv[1], t.first) != 0) continue;
+        std::printf("%s\n", t.first);
+        ++run;
+        if (!t.second()) ++failed;
+    }
+    if (run == 0) {
+        std::fprintf(stderr, "unknown test: %s\n", argv[1]);
+        return 1;
+    }
+    std::printf("%d of %d passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}
\ No newline at end of file
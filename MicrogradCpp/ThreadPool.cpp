@@ -0,0 +1,74 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+void ThreadPool::parallel_for(int n, const std::function<void(int)>& fn) {
+    if (n <= 0) return;
+    if (workers.empty() || n == 1) {
+        for (int i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    // Each job has its own counters, so a worker that wakes up late and
+    // still holds a finished job finds nothing left to take from it.
+    auto j = std::make_shared<Job>();
+    j->fn = &fn;
+    j->n = n;
+    j->remaining = n;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = j;
+        ++generation;
+    }
+    wake.notify_all();
+
+    run(*j);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return j->remaining.load() == 0; });
+}
+
+void ThreadPool::run(Job& j) {
+    int i;
+    while ((i = j.next.fetch_add(1)) < j.n) {
+        (*j.fn)(i);
+        if (j.remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::worker_loop() {
+    uint64_t seen = 0;
+    while (true) {
+        std::shared_ptr<Job> j;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+            j = job;
+        }
+        run(*j);
+    }
+}
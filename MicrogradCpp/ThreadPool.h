@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+// Fixed set of worker threads running parallel_for jobs.
+// Indices are handed out one at a time from an atomic counter, so a
+// worker that finishes early simply takes the next index (no static split).
+class ThreadPool {
+  public:
+    // threads = total threads working on a job, including the caller.
+    // 0 means one per hardware thread.
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)workers.size() + 1; }
+
+    // Run fn(i) for every i in [0, n) and return once all calls are done.
+    // The calling thread works on the job too.
+    void parallel_for(int n, const std::function<void(int)>& fn);
+
+  private:
+    struct Job {
+        const std::function<void(int)>* fn;
+        int n;
+        std::atomic<int> next{ 0 };
+        std::atomic<int> remaining;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::shared_ptr<Job> job;
+    uint64_t generation = 0;
+    bool stop = false;
+
+    void worker_loop();
+    void run(Job& j);
+};
@@ -0,0 +1,158 @@
+#include "Trainer.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+
+DataParallelTrainer::DataParallelTrainer(MLP& model, int threads)
+    : model(model), pool(threads)
+{
+}
+
+double DataParallelTrainer::backward(const std::shared_ptr<Tensor>& X, const std::shared_ptr<Tensor>& Y) {
+    const int N = X->rows;
+    const int shards = std::max(1, std::min(pool.size(), N));
+    const ParameterSpan span = model.parameter_span();
+    const size_t P = span.size;
+
+    local_grads.resize(shards);
+    local_loss.assign(shards, 0.0);
+
+    // 1. Forward/backward per shard into private gradient buffers
+    pool.parallel_for(shards, [&](int s) {
+        int r0 = (int)((long long)N * s / shards);
+        int r1 = (int)((long long)N * (s + 1) / shards);
+
+        auto Xs = Tensor::from_data(r1 - r0, X->cols,
+            std::vector<Scalar>(X->data.begin() + (size_t)r0 * X->cols, X->data.begin() + (size_t)r1 * X->cols));
+        auto Ys = Tensor::from_data(r1 - r0, Y->cols,
+            std::vector<Scalar>(Y->data.begin() + (size_t)r0 * Y->cols, Y->data.begin() + (size_t)r1 * Y->cols));
+
+        auto& g = local_grads[s];
+        g.assign(P, 0.0);
+
+        auto loss = model(Xs, g.data())->sub(Ys)->pow(2)->sum();
+        loss->backward();
+        local_loss[s] = loss->data[0];
+        });
+
+    // 2. Reduce: each task owns one slice of the parameter range of the grad storage
+    const int slices = std::max(1, (int)std::min<size_t>(pool.size(), P));
+    pool.parallel_for(slices, [&](int c) {
+        size_t p0 = P * c / slices;
+        size_t p1 = P * (c + 1) / slices;
+        for (int s = 0; s < shards; ++s) {
+            kernels::axpy((int)(p1 - p0), 1.0, local_grads[s].data() + p0, span.grad + p0);
+        }
+        });
+
+    double loss = 0.0;
+    for (double l : local_loss) {
+        loss += l;
+    }
+    return loss;
+}
+
+// --------------------------------------------------------------------------
+// HOGWILD TRAINER
+// --------------------------------------------------------------------------
+
+HogwildTrainer::HogwildTrainer(MLP& model, double lr, int threads, int batch, uint64_t seed)
+    : model(model), lr(lr), threads(threads), batch(std::max(1, batch)), seed(seed)
+{
+    if (this->threads <= 0) {
+        this->threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+}
+
+TrainingLog HogwildTrainer::train(const std::shared_ptr<Tensor>& X, const std::shared_ptr<Tensor>& Y, int epochs) {
+    const int N = X->rows;
+    const int T = std::max(1, std::min(threads, N));
+    const ParameterSpan span = model.parameter_span();
+    const size_t P = span.size;
+    const auto start = std::chrono::steady_clock::now();
+
+    TrainingLog log;
+    log.seconds.assign(epochs, 0.0);
+    log.loss.assign(epochs, 0.0);
+    std::vector<int> reports(epochs, 0);
+    std::mutex mutex;
+
+    auto worker = [&](int t) {
+        std::mt19937_64 rng(seed + (uint64_t)t);
+        std::vector<int> rows;
+        for (int r = t; r < N; r += T) rows.push_back(r);
+        std::vector<Scalar> g(P);
+        std::vector<Scalar> w(T > 1 ? P : 0);
+
+        for (int e = 0; e < epochs; ++e) {
+            std::shuffle(rows.begin(), rows.end(), rng);
+            double sum = 0.0;
+
+            for (size_t b0 = 0; b0 < rows.size(); b0 += batch) {
+                const int n = (int)std::min(rows.size() - b0, (size_t)batch);
+                std::vector<Scalar> xb((size_t)n * X->cols), yb((size_t)n * Y->cols);
+                for (int i = 0; i < n; ++i) {
+                    const size_t r = (size_t)rows[b0 + i];
+                    std::copy_n(X->data.begin() + r * X->cols, X->cols, xb.begin() + (size_t)i * X->cols);
+                    std::copy_n(Y->data.begin() + r * Y->cols, Y->cols, yb.begin() + (size_t)i * Y->cols);
+                }
+
+                // 1. Snapshot the shared parameters. Other threads keep adding
+                // to them, so they are read atomically, and the Tensor kernels
+                // then run on the private copy with ordinary loads.
+                const Scalar* params = span.data;
+                if (T > 1) {
+                    for (size_t i = 0; i < P; ++i) w[i] = atomic_read(span.data[i]);
+                    params = w.data();
+                }
+
+                // 2. Forward/backward into the private buffer
+                std::fill(g.begin(), g.end(), 0.0);
+                auto Yb = Tensor::from_data(n, Y->cols, std::move(yb));
+                auto Xb = Tensor::from_data(n, X->cols, std::move(xb));
+                auto loss = model(Xb, g.data(), params)->sub(Yb)->pow(2)->sum();
+                loss->backward();
+                sum += loss->data[0];
+
+                // 3. Update the shared parameters in place, no barrier.
+                // Alone, the plain SIMD update is safe and much cheaper.
+                if (T == 1) {
+                    kernels::axpy((int)P, (Scalar)(-lr), g.data(), span.data);
+                    continue;
+                }
+                for (size_t i = 0; i < P; ++i) {
+                    if (g[i] != 0.0) atomic_add(span.data[i], (Scalar)(-lr * g[i]));
+                }
+            }
+
+            // The last thread to finish epoch e records it
+            std::lock_guard<std::mutex> lock(mutex);
+            log.loss[e] += sum;
+            if (++reports[e] == T) {
+                log.seconds[e] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                log.loss[e] /= N;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < T; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+    return log;
+}
+
+std::ostream& operator<<(std::ostream& os, const TrainingLog& log) {
+    for (size_t e = 0; e < log.loss.size(); ++e) {
+        os << "Epoch " << e << " | " << log.seconds[e] * 1e3 << " ms | Loss: " << log.loss[e] << "\n";
+    }
+    return os;
+}
\ No newline at end of file
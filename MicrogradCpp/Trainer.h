@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <iostream>
+#include "MLP.h"
+#include "Tensor.h"
+#include "ThreadPool.h"
+
+// --------------------------------------------------------------------------
+// DATA-PARALLEL TRAINER
+// --------------------------------------------------------------------------
+// Splits a mini-batch by rows across a thread pool. Every worker runs the
+// batched Tensor forward/backward on its shard against the shared MLP, but
+// its parameter gradients land in a private buffer (MLP's grad_sink), so
+// no two threads ever write the same Value::grad.
+//
+// The buffers are then reduced in parallel: each thread owns a slice of the
+// parameter range and sums that slice across all buffers into the model's
+// grad storage. No locks or atomics are needed on the gradients.
+//
+// Usage is the same as a single-threaded step:
+//     optimizer.zero_grad();
+//     double loss = trainer.backward(X, Y);   // instead of loss->backward()
+//     optimizer.step();
+
+struct DataParallelTrainer {
+    MLP& model;
+    ThreadPool pool;
+
+    // threads = 0 means one per hardware thread
+    DataParallelTrainer(MLP& model, int threads = 0);
+
+    // Sum-of-squared-errors loss of model(X) against Y (both N rows).
+    // Adds d(loss)/d(param) into every parameter's grad and returns the loss.
+    double backward(const std::shared_ptr<Tensor>& X, const std::shared_ptr<Tensor>& Y);
+
+  private:
+    std::vector<std::vector<Scalar>> local_grads; // one buffer per shard, parameters() order
+    std::vector<double> local_loss;
+};
+
+// --------------------------------------------------------------------------
+// HOGWILD TRAINER
+// --------------------------------------------------------------------------
+// Asynchronous SGD: every thread loops over its own share of the rows in
+// mini-batches. For each one it takes a snapshot of the shared parameters,
+// runs the Tensor forward/backward on the snapshot into a private gradient
+// buffer (param_source and grad_sink, so no Value is touched), and
+// immediately applies data -= lr * grad to the shared parameters with
+// lock-free atomic adds. There is no barrier and no reduction: a snapshot
+// may hold some of another thread's update and not the rest, which is the
+// point of the method (Hogwild!; it converges when updates are sparse or
+// small relative to each other). Every shared access is atomic, so this is
+// not a data race and TSan builds stay clean.
+//
+// Only nonzero gradient entries are written, so dead ReLUs and zero
+// inputs cost no atomics.
+//
+//     HogwildTrainer trainer(model, 0.01, 8);
+//     TrainingLog log = trainer.train(X, Y, 10);
+//     std::cout << log;
+//
+// threads = 1 is the ordinary single-threaded mini-batch SGD loop.
+
+// Per epoch: when it ended (seconds since train() started) and the mean
+// per-row loss over its mini-batches
+struct TrainingLog {
+    std::vector<double> seconds;
+    std::vector<double> loss;
+};
+
+std::ostream& operator<<(std::ostream& os, const TrainingLog& log);
+
+struct HogwildTrainer {
+    MLP& model;
+    double lr;
+    int threads;
+    int batch;     // rows per update
+    uint64_t seed; // row shuffling
+
+    // threads = 0 means one per hardware thread
+    HogwildTrainer(MLP& model, double lr, int threads = 0, int batch = 1, uint64_t seed = 0);
+
+    // epochs passes over the N rows of X and Y with the sum-of-squared-errors
+    // loss. Thread t owns rows t, t + threads, ...; an epoch ends when every
+    // thread has gone once over its rows.
+    TrainingLog train(const std::shared_ptr<Tensor>& X, const std::shared_ptr<Tensor>& Y, int epochs);
+};
\ No newline at end of file
@@ -1,56 +1,72 @@
 #include "Value.h"
+#include "Profile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+#ifdef MICROGRAD_PROFILE
+// Memory of a node as counted by the profiler: the node and its child list
+static size_t node_bytes(const Value& v) {
+    return sizeof(Value) + v._prev.capacity() * sizeof(std::shared_ptr<Value>);
+}
+#endif
 
 // Constructor
-Value::Value(double data, std::vector<std::shared_ptr<Value>> children, std::string _op)
-    : data(data), grad(0.0), op(_op), _prev(children.begin(), children.end()), _backward([]() {})
+Value::Value(Scalar data, std::vector<std::shared_ptr<Value>> children, Op op)
+    : data(_own_data), grad(_own_grad), op(op), _prev(std::move(children)),
+      _own_data(data), _own_grad(0.0)
 {
+    MG_PROFILE_NODE_CREATED(op, node_bytes(*this));
+}
+
+// View Constructor
+Value::Value(Scalar* data_slot, Scalar* grad_slot, std::shared_ptr<void> storage)
+    : data(*data_slot), grad(*grad_slot),
+      _own_data(0.0), _own_grad(0.0), _storage(std::move(storage))
+{
+    MG_PROFILE_NODE_CREATED(op, node_bytes(*this));
+}
+
+// Destructor
+// Releasing a node releases its children, which release theirs, ... so a
+// long chain would recurse once per node. Unlink iteratively instead.
+Value::~Value() {
+    MG_PROFILE_NODE_DESTROYED(node_bytes(*this));
+    std::vector<std::shared_ptr<Value>> pending = std::move(_prev);
+
+    while (!pending.empty()) {
+        std::shared_ptr<Value> v = std::move(pending.back());
+        pending.pop_back();
+        if (v.use_count() == 1) {
+            // Last owner: take over its children before it is freed
+            for (auto& child : v->_prev) {
+                pending.push_back(std::move(child));
+            }
+            v->_prev.clear();
+        }
+    }
 }
 
 // --------------------------------------------------------------------------
 // CORE MATH
 // --------------------------------------------------------------------------
+// Each op only records its op code and children; the matching gradient
+// is in _backward() below.
 
 std::shared_ptr<Value> Value::add(std::shared_ptr<Value> rhs) {
     auto lhs = shared_from_this();
-    auto out = std::make_shared<Value>(lhs->data + rhs->data, std::vector<std::shared_ptr<Value>>{ lhs, rhs }, "+");
-
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [lhs, rhs, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            lhs->grad += 1.0 * out_ptr->grad;
-            rhs->grad += 1.0 * out_ptr->grad;
-        }
-        };
-    return out;
+    return std::make_shared<Value>(lhs->data + rhs->data, std::vector<std::shared_ptr<Value>>{ lhs, rhs }, Op::Add);
 }
 
 std::shared_ptr<Value> Value::mul(std::shared_ptr<Value> rhs) {
     auto lhs = shared_from_this();
-    auto out = std::make_shared<Value>(lhs->data * rhs->data, std::vector<std::shared_ptr<Value>>{ lhs, rhs }, "*");
-
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [lhs, rhs, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            lhs->grad += (rhs->data * out_ptr->grad);
-            rhs->grad += (lhs->data * out_ptr->grad);
-        }
-        };
-    return out;
+    return std::make_shared<Value>(lhs->data * rhs->data, std::vector<std::shared_ptr<Value>>{ lhs, rhs }, Op::Mul);
 }
 
-std::shared_ptr<Value> Value::pow(double exponent) {
+std::shared_ptr<Value> Value::pow(Scalar exponent) {
     auto self = shared_from_this();
-    auto out = std::make_shared<Value>(std::pow(self->data, exponent), std::vector<std::shared_ptr<Value>>{self}, "**" + std::to_string(exponent));
-
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [self, exponent, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            self->grad += (exponent * std::pow(self->data, exponent - 1.0)) * out_ptr->grad;
-        }
-        };
+    auto out = std::make_shared<Value>(std::pow(self->data, exponent), std::vector<std::shared_ptr<Value>>{ self }, Op::Pow);
+    out->_aux = exponent;
     return out;
 }
 
@@ -60,62 +76,124 @@ std::shared_ptr<Value> Value::pow(double exponent) {
 
 std::shared_ptr<Value> Value::relu() {
     auto self = shared_from_this();
-    auto out = std::make_shared<Value>(self->data < 0 ? 0.0 : self->data, std::vector<std::shared_ptr<Value>>{ self }, "ReLU");
-
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [self, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            self->grad += (out_ptr->data > 0 ? 1.0 : 0.0) * out_ptr->grad;
-        }
-        };
-    return out;
+    return std::make_shared<Value>(self->data < 0 ? 0.0 : self->data, std::vector<std::shared_ptr<Value>>{ self }, Op::ReLU);
 }
 
 // Added Tanh to match Micrograd
 std::shared_ptr<Value> Value::tanh() {
     auto self = shared_from_this();
-    double x = self->data;
-    double t = (std::exp(2 * x) - 1) / (std::exp(2 * x) + 1); // tanh formula
-
-    auto out = std::make_shared<Value>(t, std::vector<std::shared_ptr<Value>>{self}, "tanh");
-
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [self, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            // d/dx tanh(x) = 1 - tanh(x)^2
-            double t = out_ptr->data;
-            self->grad += (1.0 - t * t) * out_ptr->grad;
-        }
-        };
-    return out;
+    return std::make_shared<Value>(std::tanh(self->data), std::vector<std::shared_ptr<Value>>{ self }, Op::Tanh);
 }
 
 // Added Exp to match Micrograd
 std::shared_ptr<Value> Value::exp() {
     auto self = shared_from_this();
-    auto out = std::make_shared<Value>(std::exp(self->data), std::vector<std::shared_ptr<Value>>{self}, "exp");
+    return std::make_shared<Value>(std::exp(self->data), std::vector<std::shared_ptr<Value>>{ self }, Op::Exp);
+}
 
-    std::weak_ptr<Value> weak_out = out;
-    out->_backward = [self, weak_out]() {
-        auto out_ptr = weak_out.lock();
-        if (out_ptr) {
-            self->grad += out_ptr->data * out_ptr->grad; // d/dx e^x = e^x
-        }
-        };
+// --------------------------------------------------------------------------
+// FUSED OPS
+// --------------------------------------------------------------------------
+
+static Scalar activate(Act act, Scalar a) {
+    switch (act) {
+    case Act::ReLU: return a < 0 ? 0.0 : a;
+    case Act::Tanh: return std::tanh(a);
+    case Act::None: break;
+    }
+    return a;
+}
+
+// act(b + sum_i w[i] * x[i]) for a DotBiasAct node, from its children [w..., x..., b]
+static Scalar dot_bias_act_data(const Value& v) {
+    const auto& p = v._prev;
+    const size_t n = (p.size() - 1) / 2;
+    Scalar a = p[2 * n]->data;
+    for (size_t i = 0; i < n; ++i) {
+        a += p[i]->data * p[n + i]->data;
+    }
+    return activate(v._act, a);
+}
+
+std::shared_ptr<Value> Value::dot_bias_act(const std::vector<std::shared_ptr<Value>>& w,
+                                           const std::vector<std::shared_ptr<Value>>& x,
+                                           const std::shared_ptr<Value>& b, Act act) {
+    const size_t n = w.size();
+    std::vector<std::shared_ptr<Value>> children;
+    children.reserve(2 * n + 1);
+    children.insert(children.end(), w.begin(), w.end());
+    children.insert(children.end(), x.begin(), x.begin() + n);
+    children.push_back(b);
+
+    auto out = std::make_shared<Value>(0.0, std::move(children), Op::DotBiasAct);
+    out->_act = act;
+    out->data = dot_bias_act_data(*out);
     return out;
 }
 
+// --------------------------------------------------------------------------
+// GRADIENTS
+// --------------------------------------------------------------------------
+
+// add(child, g) adds g into child->grad: a plain += for backward(), an
+// atomic add for shared children in the parallel backward.
+template <typename Accumulate>
+static void backward_node(Value& v, Accumulate add) {
+    const auto& p = v._prev;
+    const Scalar grad = v.grad, data = v.data;
+    switch (v.op) {
+    case Op::Leaf:
+        break;
+    case Op::Add:
+        add(p[0].get(), grad);
+        add(p[1].get(), grad);
+        break;
+    case Op::Mul:
+        add(p[0].get(), p[1]->data * grad);
+        add(p[1].get(), p[0]->data * grad);
+        break;
+    case Op::Pow:
+        add(p[0].get(), (v._aux * std::pow(p[0]->data, v._aux - 1.0)) * grad);
+        break;
+    case Op::ReLU:
+        add(p[0].get(), (data > 0 ? 1.0 : 0.0) * grad);
+        break;
+    case Op::Tanh:
+        // d/dx tanh(x) = 1 - tanh(x)^2
+        add(p[0].get(), (1.0 - data * data) * grad);
+        break;
+    case Op::Exp:
+        add(p[0].get(), data * grad); // d/dx e^x = e^x
+        break;
+    case Op::DotBiasAct: {
+        Scalar g = grad;
+        if (v._act == Act::ReLU) g *= data > 0 ? 1.0 : 0.0;
+        if (v._act == Act::Tanh) g *= 1.0 - data * data;
+
+        const size_t n = (p.size() - 1) / 2;
+        for (size_t i = 0; i < n; ++i) {
+            add(p[i].get(), p[n + i]->data * g);
+            add(p[n + i].get(), p[i]->data * g);
+        }
+        add(p[2 * n].get(), g);
+        break;
+    }
+    }
+}
+
+void Value::_backward() {
+    backward_node(*this, [](Value* child, Scalar g) { child->grad += g; });
+}
+
 // --------------------------------------------------------------------------
 // CONVENIENCE WRAPPERS
 // --------------------------------------------------------------------------
 
-std::shared_ptr<Value> Value::add(double rhs) {
+std::shared_ptr<Value> Value::add(Scalar rhs) {
     return add(std::make_shared<Value>(rhs));
 }
 
-std::shared_ptr<Value> Value::mul(double rhs) {
+std::shared_ptr<Value> Value::mul(Scalar rhs) {
     return mul(std::make_shared<Value>(rhs));
 }
 
@@ -125,13 +203,13 @@ std::shared_ptr<Value> Value::mul(double rhs) {
 
 // Addition
 std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, const std::shared_ptr<Value>& rhs) { return lhs->add(rhs); }
-std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, double rhs) { return lhs->add(rhs); }
-std::shared_ptr<Value> operator+(double lhs, const std::shared_ptr<Value>& rhs) { return rhs->add(lhs); }
+std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, Scalar rhs) { return lhs->add(rhs); }
+std::shared_ptr<Value> operator+(Scalar lhs, const std::shared_ptr<Value>& rhs) { return rhs->add(lhs); }
 
 // Multiplication
 std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, const std::shared_ptr<Value>& rhs) { return lhs->mul(rhs); }
-std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, double rhs) { return lhs->mul(rhs); }
-std::shared_ptr<Value> operator*(double lhs, const std::shared_ptr<Value>& rhs) { return rhs->mul(lhs); }
+std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, Scalar rhs) { return lhs->mul(rhs); }
+std::shared_ptr<Value> operator*(Scalar lhs, const std::shared_ptr<Value>& rhs) { return rhs->mul(lhs); }
 
 // Negation & Subtraction
 std::shared_ptr<Value> operator-(const std::shared_ptr<Value>& rhs) { return rhs->mul(-1.0); }
@@ -150,28 +228,215 @@ std::ostream& operator<<(std::ostream& os, const std::shared_ptr<Value>& v) {
 // ENGINE
 // --------------------------------------------------------------------------
 
-void Value::backward() {
-    std::vector<std::shared_ptr<Value>> topo;
-    std::unordered_set<std::shared_ptr<Value>> visited;
+// Every traversal gets a fresh epoch, so 'visited' is a single compare
+// against a field on the node instead of a hash-set lookup.
+// Atomic so graphs built on different threads never share an epoch.
+static std::atomic<uint32_t> topo_epoch{ 0 };
+
+void Value::build_topo(std::vector<Value*>& topo) {
+    const uint32_t epoch = ++topo_epoch;
+    topo.clear();
+
+    // Explicit DFS stack of (node, index of the next child to visit)
+    std::vector<std::pair<Value*, size_t>> stack;
+    stack.emplace_back(this, 0);
+    _visited = epoch;
 
-    std::function<void(std::shared_ptr<Value>)> build_topo = [&](std::shared_ptr<Value> v) {
-        if (visited.find(v) == visited.end()) {
-            visited.insert(v);
-            for (const auto& child : v->_prev) {
-                build_topo(child);
+    while (!stack.empty()) {
+        Value* v = stack.back().first;
+        size_t& next = stack.back().second;
+        if (next < v->_prev.size()) {
+            Value* child = v->_prev[next++].get();
+            if (child->_visited != epoch) {
+                child->_visited = epoch;
+                stack.emplace_back(child, 0);
             }
+        }
+        else {
+            // All children emitted: post-order position
             topo.push_back(v);
+            stack.pop_back();
         }
-        };
+    }
+}
 
-    build_topo(shared_from_this());
+void Value::backward(bool retain_topo) {
+    // Scratch order reused across calls when not retained on the node
+    static thread_local std::vector<Value*> scratch;
+
+    if (retain_topo && _topo.empty()) {
+        MG_PROFILE_SCOPE("Value.backward.topo");
+        build_topo(_topo);
+    }
+    std::vector<Value*>* topo = &_topo;
+    if (_topo.empty()) {
+        MG_PROFILE_SCOPE("Value.backward.topo");
+        build_topo(scratch);
+        topo = &scratch;
+    }
+
+    MG_PROFILE_SCOPE("Value.backward.propagate");
+    // Intermediate grads may hold a previous pass when the graph is reused
+    for (Value* v : *topo) {
+        if (!v->_prev.empty()) v->grad = 0.0;
+    }
     this->grad = 1.0;
 
-    for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+    for (auto it = topo->rbegin(); it != topo->rend(); ++it) {
         (*it)->_backward();
     }
 }
+
+void Value::forward() {
+    if (_topo.empty()) {
+        build_topo(_topo);
+    }
+
+    for (Value* v : _topo) {
+        const auto& p = v->_prev;
+        switch (v->op) {
+        case Op::Leaf: break;
+        case Op::Add:  v->data = p[0]->data + p[1]->data; break;
+        case Op::Mul:  v->data = p[0]->data * p[1]->data; break;
+        case Op::Pow:  v->data = std::pow(p[0]->data, v->_aux); break;
+        case Op::ReLU: v->data = p[0]->data < 0 ? 0.0 : p[0]->data; break;
+        case Op::Tanh: v->data = std::tanh(p[0]->data); break;
+        case Op::Exp:  v->data = std::exp(p[0]->data); break;
+        case Op::DotBiasAct: v->data = dot_bias_act_data(*v); break;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------
+// PARALLEL BACKWARD
+// --------------------------------------------------------------------------
+
+// Child edges per task: enough work to be worth handing to another
+// thread, small enough to balance a level.
+static const size_t BACKWARD_GRAIN = 4096;
+
+struct BackwardSchedule {
+    std::vector<Value*> order;       // interior nodes sorted by level
+    std::vector<size_t> tasks;       // task t is order[tasks[t], tasks[t + 1])
+    std::vector<size_t> level_tasks; // level l is tasks [level_tasks[l], level_tasks[l + 1])
+};
+
+static void build_schedule(const std::vector<Value*>& topo, BackwardSchedule& s) {
+    static thread_local std::vector<size_t> level_start; // level l is order[level_start[l], level_start[l + 1])
+    static thread_local std::vector<size_t> fill;
+
+    for (Value* v : topo) {
+        v->_level = 0;
+        v->_task = 0;
+    }
+
+    // 1. Levels, in reverse topological order: a node's level is final
+    // once all its consumers have been seen
+    uint32_t depth = 0;
+    for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+        Value* v = *it;
+        for (const auto& child : v->_prev) {
+            child->_level = std::max(child->_level, v->_level + 1);
+        }
+        depth = std::max(depth, v->_level);
+    }
+
+    // 2. Counting sort of the interior nodes by level (leaves have no backward)
+    level_start.assign((size_t)depth + 2, 0);
+    for (Value* v : topo) {
+        if (!v->_prev.empty()) ++level_start[v->_level + 1];
+    }
+    for (size_t l = 1; l < level_start.size(); ++l) {
+        level_start[l] += level_start[l - 1];
+    }
+    s.order.resize(level_start.back());
+    fill.assign(level_start.begin(), level_start.end() - 1);
+    for (Value* v : topo) {
+        if (!v->_prev.empty()) s.order[fill[v->_level]++] = v;
+    }
+
+    // 3. Tasks of about BACKWARD_GRAIN child edges within each level
+    s.tasks.clear();
+    s.level_tasks.clear();
+    for (size_t l = 0; l + 1 < level_start.size(); ++l) {
+        s.level_tasks.push_back(s.tasks.size());
+        size_t edges = BACKWARD_GRAIN;
+        for (size_t i = level_start[l]; i < level_start[l + 1]; ++i) {
+            if (edges >= BACKWARD_GRAIN) {
+                s.tasks.push_back(i);
+                edges = 0;
+            }
+            edges += s.order[i]->_prev.size();
+        }
+    }
+    s.level_tasks.push_back(s.tasks.size());
+    s.tasks.push_back(s.order.size());
+
+    // 4. A grad needs atomic adds only if two tasks of the same level add
+    // into it. Tasks are numbered in level order, so a stamp past the
+    // level's first task is from the same level. _shared is only ever set:
+    // a leaf shared with another graph keeps that graph's plan valid too.
+    for (size_t l = 0; l + 1 < s.level_tasks.size(); ++l) {
+        for (size_t t = s.level_tasks[l]; t < s.level_tasks[l + 1]; ++t) {
+            for (size_t i = s.tasks[t]; i < s.tasks[t + 1]; ++i) {
+                for (const auto& child : s.order[i]->_prev) {
+                    if (child->_task > s.level_tasks[l] && child->_task != t + 1) child->_shared = true;
+                    child->_task = (uint32_t)(t + 1);
+                }
+            }
+        }
+    }
+}
+
+void Value::backward(ThreadPool& pool, bool retain_topo) {
+    if (pool.size() == 1) {
+        backward(retain_topo);
+        return;
+    }
+
+    static thread_local BackwardSchedule scratch;
+    BackwardSchedule* s = _schedule.get();
+    if (!s) {
+        MG_PROFILE_SCOPE("Value.backward.topo");
+        static thread_local std::vector<Value*> topo;
+        build_topo(topo);
+        if (retain_topo) {
+            _schedule.reset(new BackwardSchedule());
+            s = _schedule.get();
+        }
+        else {
+            s = &scratch;
+        }
+        build_schedule(topo, *s);
+    }
+
+    MG_PROFILE_SCOPE("Value.backward.propagate");
+    for (Value* v : s->order) {
+        v->grad = 0.0;
+    }
+    this->grad = 1.0;
+
+    // Level by level; the pool hands out a level's tasks dynamically
+    auto add = [](Value* child, Scalar g) {
+        if (child->_shared) atomic_add(child->grad, g);
+        else child->grad += g;
+    };
+    // Plain pointers: inside the lambda a thread_local name would refer
+    // to the worker's own copy
+    Value* const* nodes = s->order.data();
+    const size_t* bounds = s->tasks.data();
+    for (size_t l = 0; l + 1 < s->level_tasks.size(); ++l) {
+        const size_t first = s->level_tasks[l], count = s->level_tasks[l + 1] - first;
+        pool.parallel_for((int)count, [=](int t) {
+            for (size_t i = bounds[first + t]; i < bounds[first + t + 1]; ++i) backward_node(*nodes[i], add);
+        });
+    }
+}
+
 void Value::print()
 {
-    std::cout << "Value(data=" << data << ", grad=" << grad << ", op=\"" << op << "\")" << std::endl;
+    std::cout << "Value(data=" << data << ", grad=" << grad << ", op=\"" << op_name(op);
+    if (op == Op::Pow) std::cout << _aux;
+    if (op == Op::DotBiasAct && _act != Act::None) std::cout << (_act == Act::ReLU ? "+ReLU" : "+tanh");
+    std::cout << "\")" << std::endl;
 }
\ No newline at end of file
@@ -3,44 +3,102 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <functional>
-#include <unordered_set>
+#include <cstdint>
 #include <cmath> 
+#include "Op.h"
+#include "Scalar.h"
+
+class ThreadPool;
+struct BackwardSchedule;
 
 struct Value : public std::enable_shared_from_this<Value> {
-    double data;
-    double grad;
-    std::unordered_set<std::shared_ptr<Value>> _prev;
-    std::string op;
-    std::function<void()> _backward;
+    // data and grad normally refer to this node's own two slots below.
+    // Parameters are "views" instead: they refer to their slots in a
+    // module's contiguous storage (see ParameterStore in Module.h).
+    Scalar& data;
+    Scalar& grad;
+    Op op = Op::Leaf;                          // what produced this node (op_name(op) to print)
+    std::vector<std::shared_ptr<Value>> _prev; // ordered: lhs, rhs
+
+    Scalar _aux = 0.0;     // Pow: exponent
+    Act _act = Act::None;  // DotBiasAct: activation
+
+    // Traversal bookkeeping for backward()
+    uint32_t _visited = 0;      // epoch of the last traversal that reached this node
+    std::vector<Value*> _topo;  // retained topological order (see backward(true))
+    std::unique_ptr<BackwardSchedule> _schedule; // retained plan (see backward(pool, true))
+    uint32_t _level = 0;        // parallel backward: longest distance from the root
+    uint32_t _task = 0;         // parallel backward: last task (+1) that added into grad
+    bool _shared = false;       // parallel backward: grad is added to by concurrent tasks (never reset)
 
-    Value(double data, std::vector<std::shared_ptr<Value>> children = {}, std::string _op = "");
+    Value(Scalar data, std::vector<std::shared_ptr<Value>> children = {}, Op op = Op::Leaf);
+    // View: data/grad live at *data_slot/*grad_slot; 'storage' keeps them alive
+    Value(Scalar* data_slot, Scalar* grad_slot, std::shared_ptr<void> storage);
+    ~Value();
+
+    Value(const Value&) = delete;
+    Value& operator=(const Value&) = delete;
 
     // Core Operations
     std::shared_ptr<Value> add(std::shared_ptr<Value> rhs);
     std::shared_ptr<Value> mul(std::shared_ptr<Value> rhs);
-    std::shared_ptr<Value> pow(double exponent);
+    std::shared_ptr<Value> pow(Scalar exponent);
 
     // Activations & Non-linearities
     std::shared_ptr<Value> relu();
     std::shared_ptr<Value> tanh(); // Added to match Micrograd
     std::shared_ptr<Value> exp();  // Added to match Micrograd
 
+    // Fused neuron: act(b + sum_i w[i] * x[i]) as ONE node, instead of
+    // 2 * n nodes chained n deep. Children are [w..., x..., b]; the Op::DotBiasAct
+    // case of _backward() backpropagates into all of them.
+    static std::shared_ptr<Value> dot_bias_act(const std::vector<std::shared_ptr<Value>>& w,
+                                               const std::vector<std::shared_ptr<Value>>& x,
+                                               const std::shared_ptr<Value>& b, Act act);
+
     // Convenience Wrappers
-    std::shared_ptr<Value> add(double rhs);
-    std::shared_ptr<Value> mul(double rhs);
+    std::shared_ptr<Value> add(Scalar rhs);
+    std::shared_ptr<Value> mul(Scalar rhs);
 
     // Engine
-    void backward();
+    // Add this node's gradient contribution into its children's grads.
+    // A switch on 'op': nodes carry no closure.
+    void _backward();
+
+    // Topological order of the graph ending at this node, children first.
+    // Iterative (explicit stack), so deep chains cannot overflow the call stack.
+    void build_topo(std::vector<Value*>& topo);
+
+    // Backpropagate from this node.
+    // retain_topo = true keeps the sorted order on this node, so later
+    // forward()/backward() calls on the same graph skip the sort entirely.
+    void backward(bool retain_topo = false);
+
+    // Parallel backward on 'pool'. Nodes are grouped into levels by their
+    // longest distance from this node: every consumer of a node sits on an
+    // earlier level, so once a level is done its nodes' grads are final and
+    // the whole next level can run at once (e.g. all neurons of a layer).
+    // Only grads that concurrent tasks add into (an input read by every
+    // neuron, a weight used by every sample) are accumulated atomically.
+    // A pool of one thread runs the serial backward(). retain_topo = true
+    // also keeps the level plan on this node, so later calls skip straight
+    // to the gradient work.
+    // Same result as backward() up to the order of floating-point additions.
+    void backward(ThreadPool& pool, bool retain_topo = false);
+
+    // Re-evaluate 'data' for every node of this graph (children first).
+    // Lets a training loop build the graph once and, each step, only write
+    // new input data, call forward(), zero_grad() and backward().
+    void forward();
 
     // Friend Operators
     friend std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, const std::shared_ptr<Value>& rhs);
-    friend std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, double rhs);
-    friend std::shared_ptr<Value> operator+(double lhs, const std::shared_ptr<Value>& rhs);
+    friend std::shared_ptr<Value> operator+(const std::shared_ptr<Value>& lhs, Scalar rhs);
+    friend std::shared_ptr<Value> operator+(Scalar lhs, const std::shared_ptr<Value>& rhs);
 
     friend std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, const std::shared_ptr<Value>& rhs);
-    friend std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, double rhs);
-    friend std::shared_ptr<Value> operator*(double lhs, const std::shared_ptr<Value>& rhs);
+    friend std::shared_ptr<Value> operator*(const std::shared_ptr<Value>& lhs, Scalar rhs);
+    friend std::shared_ptr<Value> operator*(Scalar lhs, const std::shared_ptr<Value>& rhs);
 
     friend std::shared_ptr<Value> operator-(const std::shared_ptr<Value>& rhs);
     friend std::shared_ptr<Value> operator-(const std::shared_ptr<Value>& lhs, const std::shared_ptr<Value>& rhs);
@@ -48,4 +106,9 @@ struct Value : public std::enable_shared_from_this<Value> {
 
     friend std::ostream& operator<<(std::ostream& os, const std::shared_ptr<Value>& v);
     void print();
+
+  private:
+    Scalar _own_data;
+    Scalar _own_grad;
+    std::shared_ptr<void> _storage; // owner of the slots, for views
 };
\ No newline at end of file